@@ -1,210 +1,4938 @@
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// residue modulo prime Mod, usable as coefficient type: Polynomial<ModInt<998244353>>
+template <uint64_t Mod>
+class ModInt {
+private:
+    // moduli above 32 bits keep value in Montgomery form a * 2^64 mod Mod,
+    // a 128-bit remainder per product is several times slower
+    static constexpr bool montgomery = Mod > UINT32_MAX;
+
+    // Mod^(-1) mod 2^64 by Newton iteration, each step doubles correct bits
+    static constexpr uint64_t InverseMod2_64() {
+        uint64_t inv = Mod;
+        for (int i = 0; i != 6; ++i)
+            inv *= 2 - Mod * inv;
+        return inv;
+    }
+
+    static constexpr uint64_t inv_mod = InverseMod2_64();
+    static constexpr uint64_t r2 = static_cast<uint64_t>(
+        static_cast<unsigned __int128>((0 - Mod) % Mod) * ((0 - Mod) % Mod) % Mod);  // 2^128 mod Mod
+
+    // x * 2^(-64) mod Mod for x < Mod * 2^64
+    static uint64_t Reduce(unsigned __int128 x) {
+        uint64_t m = static_cast<uint64_t>(x) * inv_mod;
+        uint64_t hi = static_cast<uint64_t>(x >> 64);
+        uint64_t mn = static_cast<uint64_t>((static_cast<unsigned __int128>(m) * Mod) >> 64);
+        return hi >= mn ? hi - mn : hi + (Mod - mn);
+    }
+
+    uint64_t value;
+public:
+    ModInt() : value(0) {}
+
+    template <typename I, typename = typename std::enable_if<std::is_integral<I>::value>::type>
+    ModInt(I v) {
+        if constexpr (std::is_signed<I>::value) {
+            if (v < 0) {
+                // -(v + 1) can't overflow even for the minimal value
+                uint64_t r = static_cast<uint64_t>(-(v + 1)) % Mod;
+                value = Mod - 1 - r;
+                if constexpr (montgomery)
+                    value = Reduce(static_cast<unsigned __int128>(value) * r2);
+                return;
+            }
+        }
+        value = static_cast<uint64_t>(v) % Mod;
+        if constexpr (montgomery)
+            value = Reduce(static_cast<unsigned __int128>(value) * r2);
+    }
+
+    static constexpr uint64_t Modulus() {
+        return Mod;
+    }
+
+    // returns representative in [0, Mod)
+    uint64_t Value() const {
+        if constexpr (montgomery)
+            return Reduce(value);
+        return value;
+    }
+
+    // written without value + other.value, which overflows for Mod above 2^63
+    ModInt& operator += (const ModInt& other) {
+        value = value >= Mod - other.value ? value - (Mod - other.value) : value + other.value;
+        return *this;
+    }
+
+    ModInt& operator -= (const ModInt& other) {
+        value = value >= other.value ? value - other.value : value + (Mod - other.value);
+        return *this;
+    }
+
+    ModInt& operator *= (const ModInt& other) {
+        if constexpr (montgomery)
+            value = Reduce(static_cast<unsigned __int128>(value) * other.value);
+        else
+            value = value * other.value % Mod;
+        return *this;
+    }
+
+    ModInt& operator /= (const ModInt& other) {
+        return *this *= other.Inverse();
+    }
+
+    ModInt operator + (const ModInt& other) const {
+        return ModInt(*this) += other;
+    }
+
+    ModInt operator - (const ModInt& other) const {
+        return ModInt(*this) -= other;
+    }
+
+    ModInt operator * (const ModInt& other) const {
+        return ModInt(*this) *= other;
+    }
+
+    ModInt operator / (const ModInt& other) const {
+        return ModInt(*this) /= other;
+    }
+
+    ModInt operator - () const {
+        return ModInt() - *this;
+    }
+
+    bool operator == (const ModInt& other) const {
+        return value == other.value;
+    }
+
+    bool operator != (const ModInt& other) const {
+        return value != other.value;
+    }
+
+    // order of representatives, needed only for printing signs
+    bool operator < (const ModInt& other) const {
+        return Value() < other.Value();
+    }
+
+    bool operator > (const ModInt& other) const {
+        return Value() > other.Value();
+    }
+
+    // binary exponentiation
+    ModInt Pow(uint64_t e) const {
+        ModInt result = 1, base = *this;
+        for (; e != 0; e >>= 1) {
+            if (e & 1)
+                result *= base;
+            base *= base;
+        }
+        return result;
+    }
+
+    // multiplicative inverse by Fermat's little theorem
+    ModInt Inverse() const {
+        if (value == 0)
+            throw std::domain_error("ModInt: inverse of zero");
+        return Pow(Mod - 2);
+    }
+
+    // square root by Tonelli-Shanks
+    ModInt Sqrt() const {
+        if (value == 0 || Mod == 2)
+            return *this;
+        if (Pow((Mod - 1) / 2) != ModInt(1))
+            throw std::domain_error("ModInt: square root of quadratic non-residue");
+        int s = __builtin_ctzll(Mod - 1);
+        uint64_t q = (Mod - 1) >> s;
+        ModInt z = 2;
+        while (z.Pow((Mod - 1) / 2) == ModInt(1))
+            z += ModInt(1);
+        ModInt c = z.Pow(q), t = Pow(q), r = Pow((q + 1) / 2);
+        while (t != ModInt(1)) {
+            int i = 0;
+            for (ModInt t2 = t; t2 != ModInt(1); t2 *= t2)
+                ++i;
+            ModInt b = c;
+            for (int j = 0; j != s - i - 1; ++j)
+                b *= b;
+            r *= b;
+            c = b * b;
+            t *= c;
+            s = i;
+        }
+        return r;
+    }
+
+    friend ModInt sqrt(const ModInt& a) {
+        return a.Sqrt();
+    }
+
+    friend std::ostream& operator << (std::ostream& out, const ModInt& a) {
+        return out << a.Value();
+    }
+};
+
+// real root location found by Polynomial::IsolateRealRoots: the open interval
+// (left / 2^scale, right / 2^scale) with right = left + 1 holding exactly one root,
+// or the exact root left / 2^scale when left == right; negative scales multiply
+template <typename T>
+struct RootInterval {
+    T left, right;
+    int scale;
+};
+
+// text forms of Polynomial::ToString: operator << style x^3+2*x^2-x+3, or [c0,c1,...]
+enum class PolynomialFormat {
+    Expression,
+    List
+};
+
+namespace polynomial_detail {
+
+// below these sizes asymptotically faster kernels lose to simpler ones
+const size_t KARATSUBA_THRESHOLD = 32;
+const size_t TOOM3_THRESHOLD = 128;
+const size_t TOOM4_THRESHOLD = 384;
+const size_t NTT_THRESHOLD = 64;
+const size_t KRONECKER_THRESHOLD = 1024;
+const size_t DIVISION_THRESHOLD = 64;
+const size_t UNBALANCED_RATIO = 4;
+const size_t HALF_GCD_THRESHOLD = 64;
+const size_t PARALLEL_THRESHOLD = 1 << 14;
+const size_t TAYLOR_SHIFT_THRESHOLD = 512;
+const size_t TAYLOR_SHIFT_BLOCK = 32;
+const size_t ROOTS_PARALLEL_DEGREE = 1000;
+const int ABERTH_MAX_ITERATIONS = 200;
+const size_t OUT_OF_CORE_CHUNK = size_t(1) << 20;
+const size_t COMPRESSION_BLOCK = 128;
+const size_t SPARSE_FILL_DIVISOR = 16;
+
+// out[0 .. na + nb - 1) += a * b
+template <typename T>
+void MulSchoolbook(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    for (size_t i = 0; i != na; ++i) {
+        for (size_t j = 0; j != nb; ++j)
+            out[i + j] += a[i] * b[j];
+    }
+}
+
+// out[0 .. na + nb - 1) += a * b with three half-size products per level
+template <typename T>
+void MulKaratsuba(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb < KARATSUBA_THRESHOLD) {
+        MulSchoolbook(a, na, b, nb, out);
+        return;
+    }
+    size_t m = (na + 1) / 2;
+    if (nb <= m) {
+        // b fits in the lower half: two independent products
+        MulKaratsuba(a, m, b, nb, out);
+        MulKaratsuba(a + m, na - m, b, nb, out + m);
+        return;
+    }
+    // a = a0 + x^m * a1, b = b0 + x^m * b1
+    std::vector<T> z0(2 * m - 1, T()), z2(na + nb - 2 * m - 1, T()), z1(2 * m - 1, T());
+    MulKaratsuba(a, m, b, m, z0.data());
+    MulKaratsuba(a + m, na - m, b + m, nb - m, z2.data());
+    std::vector<T> sa(a, a + m), sb(b, b + m);
+    for (size_t i = m; i != na; ++i)
+        sa[i - m] += a[i];
+    for (size_t i = m; i != nb; ++i)
+        sb[i - m] += b[i];
+    MulKaratsuba(sa.data(), m, sb.data(), m, z1.data());
+    for (size_t i = 0; i != z0.size(); ++i) {
+        z1[i] -= z0[i];
+        out[i] += z0[i];
+    }
+    for (size_t i = 0; i != z2.size(); ++i) {
+        z1[i] -= z2[i];
+        out[i + 2 * m] += z2[i];
+    }
+    for (size_t i = 0; i != z1.size(); ++i)
+        out[i + m] += z1[i];
+}
+
+// dispatches to MulToom3, MulToom4 or MulKaratsuba by size
+template <typename T>
+void MulToomCook(const T* a, size_t na, const T* b, size_t nb, T* out);
+
+// the k pieces of length m of a polynomial with n coefficients, zero padded
+template <typename T>
+std::vector<std::vector<T>> SplitPieces(const T* a, size_t n, size_t m, size_t k) {
+    std::vector<std::vector<T>> pieces(k, std::vector<T>(m, T()));
+    for (size_t i = 0; i != n; ++i)
+        pieces[i / m][i % m] = a[i];
+    return pieces;
+}
+
+// out[0 .. na + nb - 1) += a * b with five third-size products at the points 0, 1, -1, -2
+// and infinity; Bodrato's interpolation needs one exact division by 3 and two by 2
+template <typename T>
+void MulToom3(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t m = (na + 2) / 3;
+    bool square = a == b && na == nb;
+    const T two(2), three(3);
+    // values at 1, -1, -2 of a piecewise polynomial p0 + p1 y + p2 y^2
+    auto evaluate = [m, &two](const std::vector<std::vector<T>>& p, std::vector<T>* v) {
+        for (size_t j = 0; j != m; ++j) {
+            T even = p[0][j] + p[2][j];
+            v[0][j] = even + p[1][j];
+            v[1][j] = even - p[1][j];
+            v[2][j] = (v[1][j] + p[2][j]) * two - p[0][j];
+        }
+    };
+    std::vector<std::vector<T>> pa = SplitPieces(a, na, m, 3), pb;
+    std::vector<T> va[3] = {std::vector<T>(m), std::vector<T>(m), std::vector<T>(m)}, vb[3];
+    evaluate(pa, va);
+    if (!square) {
+        pb = SplitPieces(b, nb, m, 3);
+        std::fill(vb, vb + 3, std::vector<T>(m));
+        evaluate(pb, vb);
+    }
+    const std::vector<std::vector<T>>& qb = square ? pa : pb;
+    const std::vector<T>* wb = square ? va : vb;
+    size_t len = 2 * m - 1;
+    std::vector<T> r0(len, T()), r1(len, T()), rm1(len, T()), rm2(len, T()), rinf(len, T());
+    MulToomCook(pa[0].data(), m, qb[0].data(), m, r0.data());
+    MulToomCook(va[0].data(), m, wb[0].data(), m, r1.data());
+    MulToomCook(va[1].data(), m, wb[1].data(), m, rm1.data());
+    MulToomCook(va[2].data(), m, wb[2].data(), m, rm2.data());
+    MulToomCook(pa[2].data(), na - 2 * m, qb[2].data(), nb - 2 * m, rinf.data());
+    for (size_t j = 0; j != len; ++j) {
+        T c3 = (rm2[j] - r1[j]) / three;
+        T c1 = (r1[j] - rm1[j]) / two;
+        T c2 = rm1[j] - r0[j];
+        c3 = (c2 - c3) / two + rinf[j] * two;
+        c2 += c1 - rinf[j];
+        c1 -= c3;
+        r1[j] = c1;
+        rm1[j] = c2;
+        rm2[j] = c3;
+    }
+    size_t n = na + nb - 1;
+    const std::vector<T>* parts[5] = {&r0, &r1, &rm1, &rm2, &rinf};
+    for (size_t i = 0; i != 5; ++i) {
+        for (size_t j = 0; j != len && i * m + j < n; ++j)
+            out[i * m + j] += (*parts[i])[j];
+    }
+}
+
+// out[0 .. na + nb - 1) += a * b with seven quarter-size products at the points 0, 1, -1,
+// 2, -2, 1/2 and infinity; the interpolation takes exact divisions by 2, 4, 3 and 5 only
+template <typename T>
+void MulToom4(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    size_t m = (na + 3) / 4;
+    bool square = a == b && na == nb;
+    const T two(2), three(3), four(4), five(5), sixteen(16), sixty_four(64);
+    // values at 1, -1, 2, -2 and 8 p(1/2) of p0 + p1 y + p2 y^2 + p3 y^3
+    auto evaluate = [m, &two, &four](const std::vector<std::vector<T>>& p, std::vector<T>* v) {
+        for (size_t j = 0; j != m; ++j) {
+            T even = p[0][j] + p[2][j], odd = p[1][j] + p[3][j];
+            v[0][j] = even + odd;
+            v[1][j] = even - odd;
+            even = p[0][j] + p[2][j] * four;
+            odd = (p[1][j] + p[3][j] * four) * two;
+            v[2][j] = even + odd;
+            v[3][j] = even - odd;
+            v[4][j] = ((p[0][j] * two + p[1][j]) * two + p[2][j]) * two + p[3][j];
+        }
+    };
+    std::vector<std::vector<T>> pa = SplitPieces(a, na, m, 4), pb;
+    std::vector<T> va[5], vb[5];
+    std::fill(va, va + 5, std::vector<T>(m));
+    evaluate(pa, va);
+    if (!square) {
+        pb = SplitPieces(b, nb, m, 4);
+        std::fill(vb, vb + 5, std::vector<T>(m));
+        evaluate(pb, vb);
+    }
+    const std::vector<std::vector<T>>& qb = square ? pa : pb;
+    const std::vector<T>* wb = square ? va : vb;
+    size_t len = 2 * m - 1;
+    std::vector<T> c[7];
+    std::fill(c, c + 7, std::vector<T>(len, T()));
+    std::vector<T> r1(len, T()), rm1(len, T()), r2(len, T()), rm2(len, T()), rh(len, T());
+    MulToomCook(pa[0].data(), m, qb[0].data(), m, c[0].data());
+    MulToomCook(va[0].data(), m, wb[0].data(), m, r1.data());
+    MulToomCook(va[1].data(), m, wb[1].data(), m, rm1.data());
+    MulToomCook(va[2].data(), m, wb[2].data(), m, r2.data());
+    MulToomCook(va[3].data(), m, wb[3].data(), m, rm2.data());
+    MulToomCook(va[4].data(), m, wb[4].data(), m, rh.data());
+    MulToomCook(pa[3].data(), na - 3 * m, qb[3].data(), nb - 3 * m, c[6].data());
+    for (size_t j = 0; j != len; ++j) {
+        const T& c0 = c[0][j];
+        const T& c6 = c[6][j];
+        // even part from 1, -1 and 2, -2
+        T s = (r1[j] + rm1[j]) / two - c0 - c6;                                // c2 + c4
+        T t = ((r2[j] + rm2[j]) / two - c0 - c6 * sixty_four) / four;          // c2 + 4 c4
+        T c4 = (t - s) / three;
+        T c2 = s - c4;
+        // odd part, with 64 c(1/2) as the third equation
+        T o1 = (r1[j] - rm1[j]) / two;                                         // c1 + c3 + c5
+        T u = ((r2[j] - rm2[j]) / four - o1) / three;                          // c3 + 5 c5
+        T h = (rh[j] - c0 * sixty_four - c2 * sixteen - c4 * four - c6) / two;  // 16 c1 + 4 c3 + c5
+        T w = (o1 * sixteen - h) / three;                                      // 4 c3 + 5 c5
+        T c3 = (w - u) / three;
+        T c5 = (u - c3) / five;
+        c[1][j] = o1 - c3 - c5;
+        c[2][j] = c2;
+        c[3][j] = c3;
+        c[4][j] = c4;
+        c[5][j] = c5;
+    }
+    size_t n = na + nb - 1;
+    for (size_t i = 0; i != 7; ++i) {
+        for (size_t j = 0; j != len && i * m + j < n; ++j)
+            out[i * m + j] += c[i][j];
+    }
+}
+
+template <typename T>
+void MulToomCook(const T* a, size_t na, const T* b, size_t nb, T* out) {
+    if (na < nb) {
+        std::swap(a, b);
+        std::swap(na, nb);
+    }
+    if (nb < TOOM3_THRESHOLD) {
+        MulKaratsuba(a, na, b, nb, out);
+        return;
+    }
+    size_t k = nb >= TOOM4_THRESHOLD ? 4 : 3, m = (na + k - 1) / k;
+    if (nb <= (k - 1) * m) {
+        // b is missing its top piece: balanced slices of a as long as b
+        for (size_t i = 0; i < na; i += nb)
+            MulToomCook(a + i, std::min(nb, na - i), b, nb, out + i);
+        return;
+    }
+    if (k == 4)
+        MulToom4(a, na, b, nb, out);
+    else
+        MulToom3(a, na, b, nb, out);
+}
+
+// coefficient types with a number theoretic transform
+template <typename T>
+struct IsNttFriendly : std::false_type {};
+
+template <uint64_t Mod>
+struct IsNttFriendly<ModInt<Mod>> : std::true_type {};
+
+// largest k such that the transform of length 2^k exists modulo T::Modulus()
+template <typename T>
+int NttMaxLog() {
+    return __builtin_ctzll(T::Modulus() - 1);
+}
+
+// primitive root of unity of order 2^NttMaxLog()
+template <typename T>
+T NttRoot() {
+    static const T root = [] {
+        // any quadratic non-residue generates the whole 2-Sylow subgroup
+        uint64_t half = (T::Modulus() - 1) / 2;
+        T c = 2;
+        while (c.Pow(half) == T(1))
+            c += T(1);
+        return c.Pow((T::Modulus() - 1) >> NttMaxLog<T>());
+    }();
+    return root;
+}
+
+// in-place transform, size of a must be a power of two not above 2^NttMaxLog()
+template <typename T>
+void Ntt(std::vector<T>& a, bool invert) {
+    size_t n = a.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j)
+            std::swap(a[i], a[j]);
+    }
+    if (n < 2)
+        return;
+    // w[half + j] is the j-th power of the root of order 2 * half, levels stored contiguously
+    std::vector<T> w(n);
+    T root = NttRoot<T>();
+    if (invert)
+        root = root.Inverse();
+    for (size_t len = size_t(1) << NttMaxLog<T>(), half = n / 2; half != 0; len >>= 1) {
+        if (len == 2 * half) {
+            w[half] = T(1);
+            for (size_t j = 1; j != half; ++j)
+                w[half + j] = w[half + j - 1] * root;
+            half >>= 1;
+        }
+        root *= root;
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        size_t half = len / 2;
+        for (size_t i = 0; i < n; i += len) {
+            for (size_t j = 0; j != half; ++j) {
+                T u = a[i + j], v = a[i + j + half] * w[half + j];
+                a[i + j] = u + v;
+                a[i + j + half] = u - v;
+            }
+        }
+    }
+    if (invert) {
+        T n_inv = T(n).Inverse();
+        for (T& x : a)
+            x *= n_inv;
+    }
+}
+
+// smallest power of two not less than n
+inline size_t CeilPow2(size_t n) {
+    size_t p = 1;
+    while (p < n)
+        p <<= 1;
+    return p;
+}
+
+template <typename T>
+std::vector<T> NttMultiply(const std::vector<T>& a, const std::vector<T>& b) {
+    size_t n = a.size() + b.size() - 1;
+    size_t size = CeilPow2(n);
+    std::vector<T> fa(a), fb(b);
+    fa.resize(size);
+    fb.resize(size);
+    Ntt(fa, false);
+    Ntt(fb, false);
+    for (size_t i = 0; i != size; ++i)
+        fa[i] *= fb[i];
+    Ntt(fa, true);
+    fa.resize(n);
+    return fa;
+}
+
+// a * a with one forward transform instead of two
+template <typename T>
+std::vector<T> NttSquare(const std::vector<T>& a) {
+    size_t n = 2 * a.size() - 1;
+    size_t size = CeilPow2(n);
+    std::vector<T> fa(a);
+    fa.resize(size);
+    Ntt(fa, false);
+    for (T& x : fa)
+        x *= x;
+    Ntt(fa, true);
+    fa.resize(n);
+    return fa;
+}
+
+// NTT-friendly primes c * 2^50 + 1 below 2^62 for multi-modular algorithms
+constexpr uint64_t MODULAR_PRIMES[] = {
+    4601552919265804289ULL, 4546383823830515713ULL, 4522739925786820609ULL, 4512606826625236993ULL,
+    4500221927649968129ULL, 4488962928581541889ULL, 4479955729326800897ULL, 4472074429978902529ULL};
+const size_t MODULAR_PRIME_COUNT = sizeof(MODULAR_PRIMES) / sizeof(MODULAR_PRIMES[0]);
+
+// calls visit(std::integral_constant<size_t, I>) for I = 0, 1, ... while it returns true,
+// so the visitor can name ModInt<MODULAR_PRIMES[I]>
+template <size_t I = 0, typename Visitor>
+void ForEachModularPrime(Visitor&& visit) {
+    if constexpr (I < MODULAR_PRIME_COUNT) {
+        if (visit(std::integral_constant<size_t, I>()))
+            ForEachModularPrime<I + 1>(visit);
+    }
+}
+
+// a^(-1) mod m for coprime a, m by the extended Euclidean algorithm
+inline uint64_t InverseModulo(uint64_t a, uint64_t m) {
+    __int128 old_r = a % m, r = m, old_s = 1, s = 0;
+    while (r != 0) {
+        __int128 q = old_r / r;
+        std::swap(old_r, r);
+        r -= q * old_r;
+        std::swap(old_s, s);
+        s -= q * old_s;
+    }
+    return static_cast<uint64_t>((old_s % __int128(m) + m) % m);
+}
+
+// integer in the symmetric range from residues modulo at most two distinct MODULAR_PRIMES
+template <typename T>
+T ReconstructSigned(const std::vector<std::pair<uint64_t, uint64_t>>& residues) {
+    static_assert(sizeof(T) <= 8, "multi-modular reconstruction covers integers up to 64 bits");
+    uint64_t r1 = residues[0].first, p1 = residues[0].second;
+    if (residues.size() == 1)
+        return r1 > p1 / 2 ? T(-static_cast<long long>(p1 - r1)) : T(r1);
+    uint64_t r2 = residues[1].first, p2 = residues[1].second;
+    // x = r1 + p1 * t with t = (r2 - r1) / p1 mod p2
+    unsigned __int128 diff = (r2 + p2 - r1 % p2) % p2;
+    uint64_t t = static_cast<uint64_t>(diff * InverseModulo(p1 % p2, p2) % p2);
+    unsigned __int128 x = r1 + static_cast<unsigned __int128>(p1) * t, product = static_cast<unsigned __int128>(p1) * p2;
+    if (x > product / 2)
+        return T(-static_cast<__int128>(product - x));
+    return T(static_cast<__int128>(x));
+}
+
+// exact coefficient rings without a transform, such as rationals and big integers: class
+// types with the division that Toom-Cook interpolation needs for exact division by small
+// integers. Floating point stays with Karatsuba, whose evaluation points add no error
+template <typename T>
+struct IsComplex : std::false_type {};
+
+template <typename T>
+struct IsComplex<std::complex<T>> : std::true_type {};
+
+template <typename T, typename = void>
+struct IsToomFriendly : std::false_type {};
+
+template <typename T>
+struct IsToomFriendly<T, std::void_t<decltype(std::declval<T>() / std::declval<T>())>>
+    : std::integral_constant<bool, !std::is_arithmetic<T>::value && !IsNttFriendly<T>::value && !IsComplex<T>::value> {};
+
+// integer coefficient types taken by the Kronecker substitution kernel
+template <typename T>
+struct IsKroneckerFriendly
+    : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value && sizeof(T) <= 8> {};
+
+// coefficient fields whose division the half-GCD may use: prime fields, complex numbers
+// and exact non-integer types such as rationals. Anything else, like a big integer
+// with truncating division, is no field; other exact fields specialize this
+template <typename T>
+struct IsField : std::integral_constant<bool, IsNttFriendly<T>::value || IsComplex<T>::value ||
+    (std::numeric_limits<T>::is_exact && !std::numeric_limits<T>::is_integer)> {};
+
+// residues of the packed product modulo the prime P
+template <uint64_t P>
+std::vector<uint64_t> PackedProduct(const std::vector<__int128>& a, const std::vector<__int128>& b, bool square) {
+    auto reduce = [](const std::vector<__int128>& v) {
+        std::vector<ModInt<P>> r(v.size());
+        for (size_t i = 0; i != v.size(); ++i) {
+            __int128 x = v[i] % __int128(P);
+            r[i] = ModInt<P>(static_cast<uint64_t>(x < 0 ? x + __int128(P) : x));
+        }
+        return r;
+    };
+    std::vector<ModInt<P>> fa = reduce(a);
+    std::vector<ModInt<P>> product = square ? NttSquare(fa) : NttMultiply(fa, reduce(b));
+    std::vector<uint64_t> residues(product.size());
+    for (size_t i = 0; i != product.size(); ++i)
+        residues[i] = product[i].Value();
+    return residues;
+}
+
+// product of integer coefficient vectors by Kronecker substitution: every k consecutive
+// coefficients are packed into one integer as the signed digits of base 2^s, where s bits
+// hold any coefficient of the product with its sign, and the packed vectors are multiplied
+// modulo one or two NTT primes. A packed product has 2k - 1 digits, the upper k - 1 of
+// them overlap the next one. k and the number of primes minimise the transform work.
+// Returns false when the coefficient bounds need more than two primes, or two primes
+// for operands too short to repay the second transform
+template <typename T>
+bool KroneckerMultiply(const std::vector<T>& a, const std::vector<T>& b, std::vector<T>& result) {
+    auto bits = [](const std::vector<T>& v) {
+        uint64_t m = 0;
+        for (T x : v) {
+            uint64_t y = static_cast<uint64_t>(x);
+            if constexpr (std::is_signed<T>::value) {
+                if (x < 0)
+                    y = 0 - y;
+            }
+            m = std::max(m, y);
+        }
+        return m == 0 ? 0 : 64 - __builtin_clzll(m);
+    };
+    size_t n = a.size() + b.size() - 1;
+    int bits_a = bits(a), bits_b = bits(b);
+    if (bits_a == 0 || bits_b == 0) {
+        result.assign(n, T());
+        return true;
+    }
+    // every coefficient of the product is below min(|a|, |b|) * 2^(bits_a + bits_b)
+    int s = bits_a + bits_b + (64 - __builtin_clzll(std::min(a.size(), b.size()))) + 1;
+    // (2k - 1) * s bits must fit the symmetric range of the primes' product
+    size_t k1 = (61 / s + 1) / 2, k2 = (123 / s + 1) / 2;
+    if (k2 == 0)
+        return false;
+    size_t primes = k1 != 0 && 2 * k1 >= k2 ? 1 : 2, k = primes == 1 ? k1 : k2;
+    if (primes == 2 && std::min(a.size(), b.size()) < 2 * KRONECKER_THRESHOLD)
+        return false;
+    auto pack = [&](const std::vector<T>& v) {
+        std::vector<__int128> packed((v.size() + k - 1) / k);
+        for (size_t j = 0; j != packed.size(); ++j) {
+            __int128 x = 0;
+            for (size_t t = std::min(k, v.size() - j * k); t-- != 0;)
+                x = x * (__int128(1) << s) + static_cast<__int128>(v[j * k + t]);
+            packed[j] = x;
+        }
+        return packed;
+    };
+    bool square = &a == &b;
+    std::vector<__int128> pa = pack(a), pb = square ? std::vector<__int128>() : pack(b);
+    std::vector<uint64_t> r1 = PackedProduct<MODULAR_PRIMES[0]>(pa, pb, square), r2;
+    if (primes == 2)
+        r2 = PackedProduct<MODULAR_PRIMES[1]>(pa, pb, square);
+    const uint64_t p1 = MODULAR_PRIMES[0], p2 = MODULAR_PRIMES[1];
+    using F2 = ModInt<MODULAR_PRIMES[1]>;
+    const F2 inverse = F2(InverseModulo(p1 % p2, p2));
+    const unsigned __int128 product = static_cast<unsigned __int128>(p1) * p2;
+    const unsigned __int128 mask = (static_cast<unsigned __int128>(1) << s) - 1, half = mask / 2 + 1;
+    std::vector<__int128> sum(n + 2 * k, 0);
+    for (size_t j = 0; j != r1.size(); ++j) {
+        __int128 v;
+        if (primes == 1) {
+            v = r1[j] > p1 / 2 ? -__int128(p1 - r1[j]) : __int128(r1[j]);
+        } else {
+            // v = r1 + p1 * t with t = (r2 - r1) / p1 mod p2, then into the symmetric range
+            uint64_t t = ((F2(r2[j]) - F2(r1[j])) * inverse).Value();
+            unsigned __int128 x = r1[j] + static_cast<unsigned __int128>(p1) * t;
+            v = x > product / 2 ? -static_cast<__int128>(product - x) : static_cast<__int128>(x);
+        }
+        // signed digits in [-2^(s-1), 2^(s-1))
+        for (size_t t = 0; t != 2 * k - 1; ++t) {
+            unsigned __int128 low = static_cast<unsigned __int128>(v) & mask;
+            __int128 digit = low >= half ? static_cast<__int128>(low) - static_cast<__int128>(mask) - 1 : static_cast<__int128>(low);
+            sum[j * k + t] += digit;
+            v = (v - digit) >> s;
+        }
+    }
+    result.resize(n);
+    for (size_t i = 0; i != n; ++i)
+        result[i] = static_cast<T>(sum[i]);
+    return true;
+}
+
+template <typename T>
+std::vector<T> Multiply(const std::vector<T>& a, const std::vector<T>& b);
+
+// multiplier by a fixed operand b, for many products with operands of at most block
+// coefficients. When the products fit a number theoretic transform, the transform of b
+// is computed once and each product costs one forward and one inverse transform
+template <typename T>
+class FixedMultiplier {
+private:
+    std::vector<T> b, fb;
+    size_t size = 0;  // transform size, 0 when the products go through Multiply
+public:
+    FixedMultiplier(const std::vector<T>& operand, size_t block) : b(operand) {
+        if constexpr (IsNttFriendly<T>::value) {
+            size_t n = CeilPow2(block + b.size() - 1);
+            if (b.size() >= NTT_THRESHOLD && n <= (size_t(1) << NttMaxLog<T>())) {
+                size = n;
+                fb = b;
+                fb.resize(size);
+                Ntt(fb, false);
+            }
+        }
+    }
+
+    // a * b for a with na <= block coefficients
+    std::vector<T> Product(const T* a, size_t na) const {
+        if (na == 0 || b.empty())
+            return {};
+        if constexpr (IsNttFriendly<T>::value) {
+            if (size != 0) {
+                std::vector<T> fa(a, a + na);
+                fa.resize(size);
+                Ntt(fa, false);
+                for (size_t i = 0; i != size; ++i)
+                    fa[i] *= fb[i];
+                Ntt(fa, true);
+                fa.resize(na + b.size() - 1);
+                return fa;
+            }
+        }
+        return Multiply(std::vector<T>(a, a + na), b);
+    }
+};
+
+// a * b with the longer operand cut into blocks, each block product fits a transform of
+// size s and they overlap-add into the result; the shorter operand is transformed once.
+// s is the power of two with the least transform work, which for lopsided sizes is far
+// below the size of the full product
+template <typename T>
+std::vector<T> NttMultiplyUnbalanced(const std::vector<T>& a, const std::vector<T>& b) {
+    const std::vector<T>& large = a.size() >= b.size() ? a : b;
+    const std::vector<T>& small = a.size() >= b.size() ? b : a;
+    size_t limit = size_t(1) << NttMaxLog<T>(), block = 0;
+    uint64_t best = std::numeric_limits<uint64_t>::max();
+    for (size_t s = CeilPow2(small.size()); s <= limit; s <<= 1) {
+        size_t length = s - small.size() + 1, blocks = (large.size() + length - 1) / length;
+        // forward and inverse transform per block, s log s each
+        uint64_t cost = uint64_t(2 * blocks + 1) * s * __builtin_ctzll(s);
+        if (cost < best) {
+            best = cost;
+            block = length;
+        }
+        if (length >= large.size())
+            break;
+    }
+    FixedMultiplier<T> multiplier(small, block);
+    std::vector<T> result(large.size() + small.size() - 1, T());
+    for (size_t i = 0; i < large.size(); i += block) {
+        std::vector<T> part = multiplier.Product(large.data() + i, std::min(block, large.size() - i));
+        for (size_t j = 0; j != part.size(); ++j)
+            result[i + j] += part[j];
+    }
+    return result;
+}
+
+// full product of coefficient vectors, picks the fastest available kernel
+template <typename T>
+std::vector<T> Multiply(const std::vector<T>& a, const std::vector<T>& b) {
+    if (a.empty() || b.empty())
+        return {};
+    size_t n = a.size() + b.size() - 1;
+    if constexpr (IsNttFriendly<T>::value) {
+        size_t small = std::min(a.size(), b.size()), large = std::max(a.size(), b.size());
+        size_t limit = size_t(1) << NttMaxLog<T>();
+        if (small >= NTT_THRESHOLD) {
+            if (large < UNBALANCED_RATIO * small && CeilPow2(n) <= limit)
+                return NttMultiply(a, b);
+            // lopsided, or too long for one transform
+            if (CeilPow2(small) <= limit)
+                return NttMultiplyUnbalanced(a, b);
+        }
+    }
+    std::vector<T> result;
+    if constexpr (IsKroneckerFriendly<T>::value) {
+        if (std::min(a.size(), b.size()) >= KRONECKER_THRESHOLD && KroneckerMultiply(a, b, result))
+            return result;
+    }
+    result.assign(n, T());
+    if constexpr (IsToomFriendly<T>::value)
+        MulToomCook(a.data(), a.size(), b.data(), b.size(), result.data());
+    else
+        MulKaratsuba(a.data(), a.size(), b.data(), b.size(), result.data());
+    return result;
+}
+
+// out[0 .. n) += (a * b) mod x^n, skips every product landing at x^n or above
+template <typename T>
+void MulLowSchoolbook(const T* a, size_t na, const T* b, size_t nb, T* out, size_t n) {
+    for (size_t i = 0; i < na && i < n; ++i) {
+        size_t top = std::min(nb, n - i);
+        for (size_t j = 0; j != top; ++j)
+            out[i + j] += a[i] * b[j];
+    }
+}
+
+// out[0 .. n) += (a * b) mod x^n by Mulders' short product: one full product
+// of the low ~0.7n parts and two recursive short products for the cross terms
+template <typename T>
+void MulLowKaratsuba(const T* a, size_t na, const T* b, size_t nb, T* out, size_t n) {
+    na = std::min(na, n);
+    nb = std::min(nb, n);
+    if (na == 0 || nb == 0)
+        return;
+    if (na + nb - 1 <= n) {
+        MulKaratsuba(a, na, b, nb, out);  // nothing to skip
+        return;
+    }
+    if (n < KARATSUBA_THRESHOLD) {
+        MulLowSchoolbook(a, na, b, nb, out, n);
+        return;
+    }
+    size_t k = (7 * n + 9) / 10;
+    size_t ka = std::min(na, k), kb = std::min(nb, k);
+    std::vector<T> low(ka + kb - 1, T());
+    MulKaratsuba(a, ka, b, kb, low.data());
+    for (size_t i = 0; i < low.size() && i < n; ++i)
+        out[i] += low[i];
+    // x^(2k) * a1 * b1 is beyond x^n since 2k >= n
+    if (na > k)
+        MulLowKaratsuba(a + k, na - k, b, nb, out + k, n - k);
+    if (nb > k)
+        MulLowKaratsuba(a, na, b + k, nb - k, out + k, n - k);
+}
+
+// out[i] += sum a[i + j] * c[j] over j < n for i < n, a has 2n - 1 coefficients;
+// transposed Karatsuba: the Hankel matrix splits into blocks [[A, B], [B, C]]
+template <typename T>
+void MiddleKaratsuba(const T* a, const T* c, size_t n, T* out) {
+    if (n < KARATSUBA_THRESHOLD) {
+        for (size_t i = 0; i != n; ++i) {
+            for (size_t j = 0; j != n; ++j)
+                out[i] += a[i + j] * c[j];
+        }
+        return;
+    }
+    if (n % 2 != 0) {
+        // pad to even size with one zero column and one extra row
+        std::vector<T> pa(a, a + 2 * n - 1), pc(c, c + n), pout(n + 1, T());
+        pa.resize(2 * n + 1, T());
+        pc.push_back(T());
+        MiddleKaratsuba(pa.data(), pc.data(), n + 1, pout.data());
+        for (size_t i = 0; i != n; ++i)
+            out[i] += pout[i];
+        return;
+    }
+    size_t h = n / 2;
+    // top = (A - B) c0 + B (c0 + c1), bottom = B (c0 + c1) + (C - B) c1
+    std::vector<T> d1(2 * h - 1), d2(2 * h - 1), sc(h), p2(h, T());
+    for (size_t k = 0; k != 2 * h - 1; ++k) {
+        d1[k] = a[k] - a[k + h];
+        d2[k] = a[k + 2 * h] - a[k + h];
+    }
+    for (size_t j = 0; j != h; ++j)
+        sc[j] = c[j] + c[j + h];
+    MiddleKaratsuba(a + h, sc.data(), h, p2.data());
+    MiddleKaratsuba(d1.data(), c, h, out);
+    MiddleKaratsuba(d2.data(), c + h, h, out + h);
+    for (size_t i = 0; i != h; ++i) {
+        out[i] += p2[i];
+        out[i + h] += p2[i];
+    }
+}
+
+// out[0 .. 2n - 1) += a * a, each cross product a[i] * a[j] is computed once
+template <typename T>
+void SquareSchoolbook(const T* a, size_t n, T* out) {
+    for (size_t i = 0; i != n; ++i) {
+        out[2 * i] += a[i] * a[i];
+        T twice = a[i] + a[i];
+        for (size_t j = i + 1; j != n; ++j)
+            out[i + j] += twice * a[j];
+    }
+}
+
+// out[0 .. 2n - 1) += a * a with three half-size squares per level
+template <typename T>
+void SquareKaratsuba(const T* a, size_t n, T* out) {
+    if (n < KARATSUBA_THRESHOLD) {
+        SquareSchoolbook(a, n, out);
+        return;
+    }
+    size_t m = (n + 1) / 2;
+    std::vector<T> z0(2 * m - 1, T()), z2(2 * (n - m) - 1, T()), z1(2 * m - 1, T());
+    SquareKaratsuba(a, m, z0.data());
+    SquareKaratsuba(a + m, n - m, z2.data());
+    std::vector<T> sa(a, a + m);
+    for (size_t i = m; i != n; ++i)
+        sa[i - m] += a[i];
+    SquareKaratsuba(sa.data(), m, z1.data());
+    for (size_t i = 0; i != z0.size(); ++i) {
+        z1[i] -= z0[i];
+        out[i] += z0[i];
+    }
+    for (size_t i = 0; i != z2.size(); ++i) {
+        z1[i] -= z2[i];
+        out[i + 2 * m] += z2[i];
+    }
+    for (size_t i = 0; i != z1.size(); ++i)
+        out[i + m] += z1[i];
+}
+
+// a * a, picks the fastest available squaring kernel
+template <typename T>
+std::vector<T> Square(const std::vector<T>& a) {
+    if (a.empty())
+        return {};
+    size_t n = 2 * a.size() - 1;
+    if constexpr (IsNttFriendly<T>::value) {
+        if (a.size() >= NTT_THRESHOLD && CeilPow2(n) <= (size_t(1) << NttMaxLog<T>()))
+            return NttSquare(a);
+    }
+    std::vector<T> result;
+    if constexpr (IsKroneckerFriendly<T>::value) {
+        if (a.size() >= KRONECKER_THRESHOLD && KroneckerMultiply(a, a, result))
+            return result;
+    }
+    result.assign(n, T());
+    if constexpr (IsToomFriendly<T>::value) {
+        // evaluations of a are shared by both factors all the way down
+        if (a.size() >= TOOM3_THRESHOLD) {
+            MulToomCook(a.data(), a.size(), a.data(), a.size(), result.data());
+            return result;
+        }
+    }
+    SquareKaratsuba(a.data(), a.size(), result.data());
+    return result;
+}
+
+// (a * b) mod x^n, result has exactly n coefficients
+template <typename T>
+std::vector<T> LowProduct(const std::vector<T>& a, const std::vector<T>& b, size_t n) {
+    size_t na = std::min(a.size(), n), nb = std::min(b.size(), n);
+    if constexpr (IsNttFriendly<T>::value) {
+        // a cyclic transform can't drop the high half, truncated inputs is all it saves
+        if (std::min(na, nb) >= NTT_THRESHOLD && CeilPow2(na + nb - 1) <= (size_t(1) << NttMaxLog<T>())) {
+            std::vector<T> result = NttMultiply(std::vector<T>(a.begin(), a.begin() + na),
+                                                std::vector<T>(b.begin(), b.begin() + nb));
+            result.resize(n, T());
+            return result;
+        }
+    }
+    std::vector<T> result(n, T());
+    MulLowKaratsuba(a.data(), na, b.data(), nb, result.data(), n);
+    return result;
+}
+
+// coefficients of a * b from x^n upwards, i.e. (a * b) div x^n, as a low product of reversals
+template <typename T>
+std::vector<T> HighProduct(const std::vector<T>& a, const std::vector<T>& b, size_t n) {
+    if (a.empty() || b.empty() || n >= a.size() + b.size() - 1)
+        return {};
+    size_t m = a.size() + b.size() - 1 - n;
+    std::vector<T> ra(a.rbegin(), a.rbegin() + std::min(a.size(), m));
+    std::vector<T> rb(b.rbegin(), b.rbegin() + std::min(b.size(), m));
+    std::vector<T> result = LowProduct(ra, rb, m);
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+// coefficients nb - 1 .. na - 1 of a * b for na >= nb: the transposed product
+template <typename T>
+std::vector<T> MiddleProduct(const std::vector<T>& a, const std::vector<T>& b) {
+    size_t na = a.size(), nb = b.size();
+    if (nb == 0 || na < nb)
+        return {};
+    size_t m = na - nb + 1;
+    if constexpr (IsNttFriendly<T>::value) {
+        // wrap-around of a cyclic product of length >= na only spoils indices below nb - 1
+        size_t size = CeilPow2(na);
+        if (nb >= NTT_THRESHOLD && size <= (size_t(1) << NttMaxLog<T>())) {
+            std::vector<T> fa(a), fb(b);
+            fa.resize(size);
+            fb.resize(size);
+            Ntt(fa, false);
+            Ntt(fb, false);
+            for (size_t i = 0; i != size; ++i)
+                fa[i] *= fb[i];
+            Ntt(fa, true);
+            return std::vector<T>(fa.begin() + (nb - 1), fa.begin() + na);
+        }
+    }
+    std::vector<T> c(b.rbegin(), b.rend()), result(m, T());
+    // square Hankel blocks of side s along whichever dimension is longer
+    size_t s = std::min(m, nb);
+    std::vector<T> block_a(2 * s - 1), block_c(s), block_out(s);
+    for (size_t row = 0; row < m; row += s) {
+        for (size_t col = 0; col < nb; col += s) {
+            for (size_t k = 0; k != 2 * s - 1; ++k)
+                block_a[k] = row + col + k < na ? a[row + col + k] : T();
+            for (size_t k = 0; k != s; ++k)
+                block_c[k] = col + k < nb ? c[col + k] : T();
+            std::fill(block_out.begin(), block_out.end(), T());
+            MiddleKaratsuba(block_a.data(), block_c.data(), s, block_out.data());
+            for (size_t k = 0; k < s && row + k < m; ++k)
+                result[row + k] += block_out[k];
+        }
+    }
+    return result;
+}
+
+// power series 1 / f mod x^n by Newton iteration g = g * (2 - f * g)
+template <typename T>
+std::vector<T> SeriesInverse(const std::vector<T>& f, size_t n) {
+    if (f.empty() || f[0] == T())
+        throw std::domain_error("Polynomial: series inverse needs non-zero constant term");
+    std::vector<T> g{T(1) / f[0]};
+    for (size_t m = 1; m < n;) {
+        m = std::min(2 * m, n);
+        std::vector<T> e = LowProduct(f, g, m);
+        for (T& x : e)
+            x = -x;
+        e[0] += T(2);
+        g = LowProduct(g, e, m);
+    }
+    g.resize(n, T());
+    return g;
+}
+
+template <typename T>
+std::vector<T> SeriesDerivative(const std::vector<T>& f) {
+    std::vector<T> result(f.empty() ? 0 : f.size() - 1);
+    for (size_t i = 1; i < f.size(); ++i)
+        result[i - 1] = f[i] * T(i);
+    return result;
+}
+
+template <typename T>
+std::vector<T> SeriesIntegral(const std::vector<T>& f) {
+    std::vector<T> result(f.size() + 1, T());
+    for (size_t i = 0; i != f.size(); ++i)
+        result[i + 1] = f[i] / T(i + 1);
+    return result;
+}
+
+// log f = integral of f' / f mod x^n, f(0) must be 1
+template <typename T>
+std::vector<T> SeriesLog(const std::vector<T>& f, size_t n) {
+    if (f.empty() || f[0] != T(1))
+        throw std::domain_error("Polynomial: series logarithm needs constant term 1");
+    if (n == 0)
+        return {};
+    std::vector<T> result = SeriesIntegral(LowProduct(SeriesDerivative(f), SeriesInverse(f, n - 1), n - 1));
+    result.resize(n, T());
+    return result;
+}
+
+// exp f mod x^n by Newton iteration g = g * (1 - log g + f), f(0) must be 0
+template <typename T>
+std::vector<T> SeriesExp(const std::vector<T>& f, size_t n) {
+    if (!f.empty() && f[0] != T())
+        throw std::domain_error("Polynomial: series exponent needs zero constant term");
+    std::vector<T> g{T(1)};
+    for (size_t m = 1; m < n;) {
+        m = std::min(2 * m, n);
+        std::vector<T> e = SeriesLog(g, m);
+        for (size_t i = 0; i != m; ++i)
+            e[i] = (i < f.size() ? f[i] : T()) - e[i];
+        e[0] += T(1);
+        g = LowProduct(g, e, m);
+    }
+    g.resize(n, T());
+    return g;
+}
+
+// sqrt f mod x^n by Newton iteration g = (g + f / g) / 2
+template <typename T>
+std::vector<T> SeriesSqrt(const std::vector<T>& f, size_t n) {
+    size_t t = 0;
+    while (t != f.size() && f[t] == T())
+        ++t;
+    if (t == f.size() || t / 2 >= n)
+        return std::vector<T>(n, T());
+    if (t % 2 != 0)
+        throw std::domain_error("Polynomial: series square root of odd valuation");
+    std::vector<T> h(f.begin() + t, f.end());
+    size_t m = n - t / 2;
+    using std::sqrt;
+    std::vector<T> g{T(sqrt(h[0]))};
+    if (g[0] * g[0] != h[0])
+        throw std::domain_error("Polynomial: constant term has no exact square root");
+    T half = T(1) / T(2);
+    for (size_t k = 1; k < m;) {
+        k = std::min(2 * k, m);
+        std::vector<T> q = LowProduct(h, SeriesInverse(g, k), k);
+        g.resize(k, T());
+        for (size_t i = 0; i != k; ++i)
+            g[i] = (g[i] + q[i]) * half;
+    }
+    g.resize(m, T());
+    g.insert(g.begin(), t / 2, T());
+    return g;
+}
+
+template <typename T>
+T PowScalar(T base, unsigned long long e) {
+    T result = T(1);
+    for (; e != 0; e >>= 1) {
+        if (e & 1)
+            result = result * base;
+        base = base * base;
+    }
+    return result;
+}
+
+// f^k mod x^n as exp(k * log f) after factoring out the lowest term
+template <typename T>
+std::vector<T> SeriesPow(const std::vector<T>& f, unsigned long long k, size_t n) {
+    std::vector<T> result(n, T());
+    if (k == 0) {
+        if (n != 0)
+            result[0] = T(1);
+        return result;
+    }
+    size_t t = 0;
+    while (t != f.size() && f[t] == T())
+        ++t;
+    if (t == f.size() || (t != 0 && k >= (n + t - 1) / t))
+        return result;  // x^(t * k) is already beyond x^n
+    size_t shift = t * k, m = n - shift;
+    T c = f[t], c_inv = T(1) / c;
+    std::vector<T> h(f.begin() + t, f.begin() + std::min(f.size(), t + m));
+    for (T& x : h)
+        x *= c_inv;
+    std::vector<T> l = SeriesLog(h, m);
+    for (T& x : l)
+        x *= T(k);
+    std::vector<T> e = SeriesExp(l, m);
+    T scale = PowScalar(c, k);
+    for (size_t i = 0; i != m; ++i)
+        result[shift + i] = e[i] * scale;
+    return result;
+}
+
+// quotient and remainder of a / b, b must be normalized (non-zero last coefficient)
+template <typename T>
+void DivMod(const std::vector<T>& a, const std::vector<T>& b, std::vector<T>& q, std::vector<T>& r) {
+    if (b.empty())
+        throw std::domain_error("Polynomial: division by zero polynomial");
+    size_t na = a.size(), nb = b.size();
+    if (na < nb) {
+        q.clear();
+        r = a;
+        return;
+    }
+    size_t m = na - nb + 1;
+    if (!std::numeric_limits<T>::is_integer && nb >= DIVISION_THRESHOLD && m >= UNBALANCED_RATIO * nb) {
+        // long division by blocks of nb quotient coefficients from the top, each a short
+        // Newton division of a window of 2nb - 1 coefficients of the running remainder
+        size_t k = nb;
+        std::vector<T> rb(b.rbegin(), b.rend());
+        FixedMultiplier<T> inverse(SeriesInverse(rb, k), k), divisor(b, k);
+        q.assign(m, T());
+        r = a;
+        std::vector<T> top(k);
+        for (size_t end = m; end != 0;) {
+            size_t start = end >= k ? end - k : 0, len = end - start;
+            // q[start .. end) reversed is rev(top len coefficients of r) / rev(b) mod x^len
+            for (size_t i = 0; i != len; ++i)
+                top[i] = r[end + nb - 2 - i];
+            std::vector<T> rq = inverse.Product(top.data(), len);
+            for (size_t i = 0; i != len; ++i)
+                q[end - 1 - i] = rq[i];
+            // the top len coefficients of the window cancel, only the low nb - 1 change
+            std::vector<T> qb = divisor.Product(q.data() + start, len);
+            for (size_t i = 0; i != nb - 1; ++i)
+                r[start + i] -= qb[i];
+            end = start;
+        }
+        r.resize(nb - 1);
+        return;
+    }
+    if (!std::numeric_limits<T>::is_integer && std::min(m, nb) >= DIVISION_THRESHOLD) {
+        // quotient is the reversed power series rev(a) / rev(b) mod x^m
+        std::vector<T> rb(b.rbegin(), b.rbegin() + std::min(nb, m));
+        std::vector<T> ra(a.rbegin(), a.rbegin() + m);
+        q = LowProduct(ra, SeriesInverse(rb, m), m);
+        std::reverse(q.begin(), q.end());
+        std::vector<T> qb = LowProduct(b, q, nb - 1);
+        r.assign(a.begin(), a.begin() + (nb - 1));
+        for (size_t i = 0; i != nb - 1; ++i)
+            r[i] -= qb[i];
+        return;
+    }
+    q.assign(m, T());
+    r = a;
+    T lead = b.back();
+    for (size_t i = m; i-- != 0;) {
+        T t = r[i + nb - 1] / lead;
+        q[i] = t;
+        if (t != T()) {
+            for (size_t j = 0; j != nb; ++j)
+                r[i + j] -= t * b[j];
+        }
+    }
+    // truncating integer division may leave high terms, elsewhere they are zero up to rounding
+    if (!std::numeric_limits<T>::is_integer)
+        r.resize(nb - 1);
+}
+
+// strips leading zero coefficients
+template <typename T>
+void Normalize(std::vector<T>& a) {
+    while (!a.empty() && a.back() == T())
+        a.pop_back();
+}
+
+template <typename T>
+std::vector<T> Add(const std::vector<T>& a, const std::vector<T>& b) {
+    std::vector<T> result(std::max(a.size(), b.size()), T());
+    for (size_t i = 0; i != a.size(); ++i)
+        result[i] += a[i];
+    for (size_t i = 0; i != b.size(); ++i)
+        result[i] += b[i];
+    Normalize(result);
+    return result;
+}
+
+template <typename T>
+std::vector<T> Sub(const std::vector<T>& a, const std::vector<T>& b) {
+    std::vector<T> result(std::max(a.size(), b.size()), T());
+    for (size_t i = 0; i != a.size(); ++i)
+        result[i] += a[i];
+    for (size_t i = 0; i != b.size(); ++i)
+        result[i] -= b[i];
+    Normalize(result);
+    return result;
+}
+
+// a div x^k
+template <typename T>
+std::vector<T> ShiftDown(const std::vector<T>& a, size_t k) {
+    return k < a.size() ? std::vector<T>(a.begin() + k, a.end()) : std::vector<T>();
+}
+
+// 2x2 polynomial matrix of Euclidean steps, rows map (a, b) to new pair
+template <typename T>
+struct PolynomialMatrix {
+    std::vector<T> a00{T(1)}, a01, a10, a11{T(1)};
+};
+
+template <typename T>
+PolynomialMatrix<T> operator * (const PolynomialMatrix<T>& x, const PolynomialMatrix<T>& y) {
+    PolynomialMatrix<T> result;
+    result.a00 = Add(Multiply(x.a00, y.a00), Multiply(x.a01, y.a10));
+    result.a01 = Add(Multiply(x.a00, y.a01), Multiply(x.a01, y.a11));
+    result.a10 = Add(Multiply(x.a10, y.a00), Multiply(x.a11, y.a10));
+    result.a11 = Add(Multiply(x.a10, y.a01), Multiply(x.a11, y.a11));
+    return result;
+}
+
+// (a, b) := m * (a, b)
+template <typename T>
+void Apply(const PolynomialMatrix<T>& m, std::vector<T>& a, std::vector<T>& b) {
+    std::vector<T> c = Add(Multiply(m.a00, a), Multiply(m.a01, b));
+    b = Add(Multiply(m.a10, a), Multiply(m.a11, b));
+    a = std::move(c);
+}
+
+// one Euclidean step (a, b) -> (b, a mod b), m := [[0, 1], [1, -q]] * m;
+// quotients, when given, collects the quotient sequence in order
+template <typename T>
+void EuclidStep(PolynomialMatrix<T>& m, std::vector<T>& a, std::vector<T>& b, std::vector<std::vector<T>>* quotients = nullptr) {
+    std::vector<T> q, r;
+    DivMod(a, b, q, r);
+    Normalize(r);
+    std::vector<T> row0 = Sub(m.a00, Multiply(q, m.a10)), row1 = Sub(m.a01, Multiply(q, m.a11));
+    m.a00 = std::move(m.a10);
+    m.a01 = std::move(m.a11);
+    m.a10 = std::move(row0);
+    m.a11 = std::move(row1);
+    a = std::move(b);
+    b = std::move(r);
+    if (quotients)
+        quotients->push_back(std::move(q));
+}
+
+// half-GCD of normalized a, b with deg a >= deg b: returns the product M of the
+// Euclidean steps such that M * (a, b) = (c, d) with size(c) > size(a) / 2 >= size(d).
+// Only the upper halves of a and b are looked at in each recursive call
+template <typename T>
+PolynomialMatrix<T> HalfGcd(std::vector<T> a, std::vector<T> b, std::vector<std::vector<T>>* quotients = nullptr) {
+    size_t k = a.size() / 2;
+    PolynomialMatrix<T> m;
+    if (b.size() <= k)
+        return m;
+    if (a.size() < HALF_GCD_THRESHOLD) {
+        while (b.size() > k)
+            EuclidStep(m, a, b, quotients);
+        return m;
+    }
+    m = HalfGcd(ShiftDown(a, k), ShiftDown(b, k), quotients);
+    Apply(m, a, b);
+    if (b.size() <= k)
+        return m;
+    EuclidStep(m, a, b, quotients);
+    if (b.size() <= k)
+        return m;
+    size_t j = 2 * k - (a.size() - 1);
+    return HalfGcd(ShiftDown(a, j), ShiftDown(b, j), quotients) * m;
+}
+
+// returns M with M * (a, b) = (gcd, 0) for normalized a, b with deg a >= deg b
+template <typename T>
+PolynomialMatrix<T> GcdMatrix(std::vector<T> a, std::vector<T> b, std::vector<std::vector<T>>* quotients = nullptr) {
+    PolynomialMatrix<T> result;
+    while (!b.empty()) {
+        PolynomialMatrix<T> m = HalfGcd(a, b, quotients);
+        Apply(m, a, b);
+        result = m * result;
+        if (b.empty())
+            break;
+        EuclidStep(result, a, b, quotients);
+    }
+    return result;
+}
+
+// monic gcd of a and b over a field: half-GCD jumps while the operands are
+// large, plain Euclidean steps once they are small
+template <typename T>
+std::vector<T> GcdVector(std::vector<T> a, std::vector<T> b) {
+    Normalize(a);
+    Normalize(b);
+    if (a.size() < b.size())
+        std::swap(a, b);
+    while (!b.empty()) {
+        if (a.size() >= HALF_GCD_THRESHOLD) {
+            Apply(HalfGcd(a, b), a, b);
+            if (b.empty())
+                break;
+        }
+        std::vector<T> q, r;
+        DivMod(a, b, q, r);
+        Normalize(r);
+        a = std::move(b);
+        b = std::move(r);
+    }
+    if (!a.empty()) {
+        T lead_inv = T(1) / a.back();
+        for (T& x : a)
+            x *= lead_inv;
+    }
+    return a;
+}
+
+// resultant over a field from the Euclidean quotient sequence alone: remainder degrees and
+// leading coefficients follow from deg q_i = d_(i-1) - d_i and lc(r_(i-1)) = lc(q_i) lc(r_i), and
+// res(r_(i-1), r_i) = (-1)^(d_(i-1) d_i) lc(r_i)^(d_(i-1) - d_(i+1)) res(r_i, r_(i+1))
+template <typename T>
+T FieldResultant(std::vector<T> a, std::vector<T> b) {
+    Normalize(a);
+    Normalize(b);
+    if (a.empty() || b.empty())
+        return T();
+    T result = T(1);
+    if (a.size() < b.size()) {
+        if ((a.size() - 1) % 2 == 1 && (b.size() - 1) % 2 == 1)
+            result = -result;
+        std::swap(a, b);
+    }
+    if (b.size() == 1)
+        return result * PowScalar(b[0], a.size() - 1);
+    std::vector<std::vector<T>> quotients;
+    std::vector<T> x = a, y = b;
+    while (!y.empty()) {
+        if (x.size() >= HALF_GCD_THRESHOLD) {
+            Apply(HalfGcd(x, y, &quotients), x, y);
+            if (y.empty())
+                break;
+        }
+        std::vector<T> q, r;
+        DivMod(x, y, q, r);
+        Normalize(r);
+        quotients.push_back(std::move(q));
+        x = std::move(y);
+        y = std::move(r);
+    }
+    if (x.size() > 1)
+        return T();  // common factor
+    size_t d_prev = a.size() - 1, d_cur = b.size() - 1;
+    T lc_cur = b.back();
+    for (size_t i = 1; i != quotients.size(); ++i) {
+        size_t d_next = d_cur - (quotients[i].size() - 1);
+        if (d_prev % 2 == 1 && d_cur % 2 == 1)
+            result = -result;
+        result *= PowScalar(lc_cur, d_prev - d_next);
+        lc_cur = lc_cur / quotients[i].back();
+        d_prev = d_cur;
+        d_cur = d_next;
+    }
+    // the last remainder is a non-zero constant
+    return result * PowScalar(lc_cur, d_prev);
+}
+
+// resultant of integer polynomials modulo two primes not dividing the leading
+// coefficients, exact whenever the resultant fits in T
+template <typename T>
+T IntegerResultant(const std::vector<T>& a, const std::vector<T>& b) {
+    if (a.empty() || b.empty())
+        return T();
+    std::vector<std::pair<uint64_t, uint64_t>> residues;
+    ForEachModularPrime([&](auto index) {
+        using F = ModInt<MODULAR_PRIMES[decltype(index)::value]>;
+        if (F(a.back()) == F() || F(b.back()) == F())
+            return true;  // degree would drop modulo this prime
+        std::vector<F> ap(a.begin(), a.end()), bp(b.begin(), b.end());
+        residues.push_back({FieldResultant(ap, bp).Value(), F::Modulus()});
+        return residues.size() < 2;
+    });
+    return ReconstructSigned<T>(residues);
+}
+
+// gcd of all coefficients, non-negative
+template <typename T>
+T Content(const std::vector<T>& a) {
+    T c = T();
+    for (const T& x : a)
+        c = std::gcd(c, x);
+    return c;
+}
+
+// a / c coefficientwise, c divides every coefficient
+template <typename T>
+std::vector<T> DivideExact(std::vector<T> a, T c) {
+    for (T& x : a)
+        x /= c;
+    return a;
+}
+
+// true if b divides a over the integers: long division never truncates then
+template <typename T>
+bool DividesExactly(const std::vector<T>& b, const std::vector<T>& a) {
+    std::vector<T> q, r;
+    DivMod(a, b, q, r);
+    Normalize(r);
+    return r.empty();
+}
+
+// gcd of primitive integer polynomials by the primitive remainder sequence,
+// exact but with intermediate coefficient growth; fallback for ModularGcd
+template <typename T>
+std::vector<T> PrimitivePrsGcd(std::vector<T> a, std::vector<T> b) {
+    if (a.size() < b.size())
+        std::swap(a, b);
+    while (!b.empty()) {
+        // pseudo-remainder lc(b)^(deg a - deg b + 1) * a mod b
+        T lead = b.back();
+        while (a.size() >= b.size()) {
+            T top = a.back();
+            size_t shift = a.size() - b.size();
+            for (T& x : a)
+                x *= lead;
+            for (size_t j = 0; j != b.size(); ++j)
+                a[shift + j] -= top * b[j];
+            Normalize(a);
+        }
+        if (!a.empty())
+            a = DivideExact(a, Content(a));
+        std::swap(a, b);
+    }
+    if (!a.empty() && a.back() < T())
+        a = DivideExact(a, T(-1));
+    return a;
+}
+
+// gcd of integer polynomials by Brown's modular algorithm: monic gcds modulo
+// primes not dividing the leading coefficients are scaled to gcd(lc(a), lc(b)),
+// primes of too high degree are discarded as unlucky, images are joined by CRT
+// and a candidate is accepted as soon as it divides both inputs;
+// content times primitive gcd with positive leading coefficient
+template <typename T>
+std::vector<T> IntegerGcd(std::vector<T> a, std::vector<T> b) {
+    Normalize(a);
+    Normalize(b);
+    if (a.empty() || b.empty()) {
+        std::vector<T>& rest = a.empty() ? b : a;
+        if (!rest.empty() && rest.back() < T())
+            rest = DivideExact(rest, T(-1));
+        return rest;
+    }
+    T content = std::gcd(Content(a), Content(b));
+    std::vector<T> pa = DivideExact(a, Content(a)), pb = DivideExact(b, Content(b));
+    if (pa.size() < pb.size())
+        std::swap(pa, pb);
+    if (pb.size() == 1)
+        return {content};
+    T gamma = std::gcd(pa.back(), pb.back());
+    size_t best_size = pb.size() + 1;
+    std::vector<std::pair<std::vector<uint64_t>, uint64_t>> images;  // residues of gamma * monic gcd, prime
+    std::vector<T> result;
+    ForEachModularPrime([&](auto index) {
+        using F = ModInt<MODULAR_PRIMES[decltype(index)::value]>;
+        if (F(pa.back()) == F() || F(pb.back()) == F())
+            return true;
+        std::vector<F> g = GcdVector(std::vector<F>(pa.begin(), pa.end()), std::vector<F>(pb.begin(), pb.end()));
+        if (g.size() == 1) {
+            result = {content};  // coprime modulo p, hence over the integers
+            return false;
+        }
+        if (g.size() > best_size)
+            return true;  // unlucky prime
+        if (g.size() < best_size) {
+            best_size = g.size();
+            images.clear();
+        }
+        std::vector<uint64_t> residues(g.size());
+        for (size_t i = 0; i != g.size(); ++i)
+            residues[i] = (g[i] * F(gamma)).Value();
+        images.push_back({std::move(residues), F::Modulus()});
+        if (images.size() > 2)
+            images.erase(images.begin());  // two primes cover anything reconstructible into T
+        std::vector<T> candidate(best_size);
+        for (size_t i = 0; i != best_size; ++i) {
+            std::vector<std::pair<uint64_t, uint64_t>> coefficient;
+            for (const auto& image : images)
+                coefficient.push_back({image.first[i], image.second});
+            candidate[i] = ReconstructSigned<T>(coefficient);
+        }
+        candidate = DivideExact(candidate, Content(candidate));
+        if (candidate.back() < T())
+            candidate = DivideExact(candidate, T(-1));
+        if (DividesExactly(candidate, pa) && DividesExactly(candidate, pb)) {
+            result = std::move(candidate);
+            for (T& x : result)
+                x *= content;
+            return false;
+        }
+        return true;
+    });
+    if (result.empty()) {
+        result = PrimitivePrsGcd(pa, pb);
+        for (T& x : result)
+            x *= content;
+    }
+    return result;
+}
+
+// keeps nullptr arguments from taking part in template deduction
+template <typename T>
+struct NonDeduced {
+    using type = T;
+};
+
+// monic gcd of a and b with cofactors s * a + t * b = gcd; a null s or t skips
+// accumulating that column of the transformation matrix
+template <typename T>
+std::vector<T> ExtendedGcdVector(std::vector<T> a, std::vector<T> b, typename NonDeduced<std::vector<T>*>::type s,
+                                 typename NonDeduced<std::vector<T>*>::type t) {
+    Normalize(a);
+    Normalize(b);
+    if (a.size() < b.size()) {
+        std::swap(a, b);
+        std::swap(s, t);
+    }
+    // current pair is (u0 a + v0 b, u1 a + v1 b)
+    std::vector<T> u0{T(1)}, u1, v0, v1{T(1)};
+    auto update = [](const PolynomialMatrix<T>& m, std::vector<T>& x0, std::vector<T>& x1) {
+        std::vector<T> y0 = Add(Multiply(m.a00, x0), Multiply(m.a01, x1));
+        x1 = Add(Multiply(m.a10, x0), Multiply(m.a11, x1));
+        x0 = std::move(y0);
+    };
+    auto step = [](const std::vector<T>& q, std::vector<T>& x0, std::vector<T>& x1) {
+        std::vector<T> y1 = Sub(x0, Multiply(q, x1));
+        x0 = std::move(x1);
+        x1 = std::move(y1);
+    };
+    while (!b.empty()) {
+        if (a.size() >= HALF_GCD_THRESHOLD) {
+            PolynomialMatrix<T> m = HalfGcd(a, b);
+            Apply(m, a, b);
+            if (s)
+                update(m, u0, u1);
+            if (t)
+                update(m, v0, v1);
+            if (b.empty())
+                break;
+        }
+        std::vector<T> q, r;
+        DivMod(a, b, q, r);
+        Normalize(r);
+        a = std::move(b);
+        b = std::move(r);
+        if (s)
+            step(q, u0, u1);
+        if (t)
+            step(q, v0, v1);
+    }
+    if (a.empty()) {
+        u0.clear();  // both operands are zero
+        v0.clear();
+    } else {
+        T lead_inv = T(1) / a.back();
+        for (std::vector<T>* x : {&a, &u0, &v0}) {
+            for (T& c : *x)
+                c *= lead_inv;
+        }
+    }
+    if (s)
+        *s = std::move(u0);
+    if (t)
+        *t = std::move(v0);
+    return a;
+}
+
+// runs body(i) for every i < count, spread over hardware threads once the level
+// holds at least PARALLEL_THRESHOLD coefficients; exceptions reach the caller
+template <typename Body>
+void ParallelFor(size_t count, size_t work, const Body& body) {
+    size_t workers = std::min<size_t>(count, std::max(1u, std::thread::hardware_concurrency()));
+    if (workers <= 1 || work < PARALLEL_THRESHOLD) {
+        for (size_t i = 0; i < count; ++i)
+            body(i);
+        return;
+    }
+    std::atomic<size_t> next {0};
+    std::vector<std::future<void>> tasks;
+    for (size_t w = 0; w < workers; ++w) {
+        tasks.push_back(std::async(std::launch::async, [&]() {
+            for (size_t i = next++; i < count; i = next++)
+                body(i);
+        }));
+    }
+    for (std::future<void>& task : tasks)
+        task.get();
+}
+
+// f(x + a) by the classical O(n^2) scheme, only additions and multiplications by a
+template <typename T>
+void TaylorShiftClassical(T* f, size_t n, T a) {
+    if (a == T() || n < 2)
+        return;
+    // shifts by one, as in Descartes' method, need no multiplication
+    bool one = a == T(1);
+    for (size_t i = 0; i + 1 < n; ++i) {
+        for (size_t j = n - 1; j-- > i;) {
+            if (one)
+                f[j] += f[j + 1];
+            else
+                f[j] += a * f[j + 1];
+        }
+    }
+}
+
+// f(x + a) in O(M(n) log n) without divisions: shifted blocks of length b are joined
+// pairwise as lo(x + a) + (x + a)^b * hi(x + a) while b doubles up to the padded size
+template <typename T>
+std::vector<T> TaylorShiftBlocks(std::vector<T> f, T a) {
+    size_t n = f.size(), padded = CeilPow2(n), block = std::min(padded, TAYLOR_SHIFT_BLOCK);
+    f.resize(padded, T());
+    for (size_t start = 0; start < padded; start += block)
+        TaylorShiftClassical(f.data() + start, block, a);
+    std::vector<T> power(block + 1, T());  // (x + a)^block
+    power[block] = T(1);
+    TaylorShiftClassical(power.data(), power.size(), a);
+    for (; block < padded; block *= 2) {
+        for (size_t start = 0; start < padded; start += 2 * block) {
+            std::vector<T> hi(f.begin() + start + block, f.begin() + start + 2 * block);
+            std::vector<T> product = Multiply(power, hi);
+            std::fill(f.begin() + start + block, f.begin() + start + 2 * block, T());
+            for (size_t i = 0; i != product.size(); ++i)
+                f[start + i] += product[i];
+        }
+        if (2 * block < padded)
+            power = Square(power);
+    }
+    f.resize(n);
+    return f;
+}
+
+template <typename T>
+void TaylorShiftVector(std::vector<T>& f, T a) {
+    if (f.size() >= TAYLOR_SHIFT_THRESHOLD)
+        f = TaylorShiftBlocks(std::move(f), a);
+    else
+        TaylorShiftClassical(f.data(), f.size(), a);
+}
+
+// sign changes in the coefficient sequence with zeros skipped, counted up to limit
+template <typename T>
+int SignVariations(const std::vector<T>& a, int limit) {
+    int count = 0;
+    bool has_last = false, last_negative = false;
+    for (const T& x : a) {
+        if (x == T())
+            continue;
+        bool negative = x < T();
+        if (has_last && negative != last_negative && ++count == limit)
+            break;
+        has_last = true;
+        last_negative = negative;
+    }
+    return count;
+}
+
+// divides integer coefficients by their content to slow down their growth
+template <typename T>
+void RemoveContent(std::vector<T>& a) {
+    if constexpr (std::numeric_limits<T>::is_integer) {
+        T c = Content(a);
+        if (c > T(1)) {
+            for (T& x : a)
+                x /= c;
+        }
+    }
+}
+
+// signed multiprecision integer for the root code: Descartes' method grows coefficients
+// by up to deg f bits per bisection level, so builtin integer polynomials are isolated
+// on this type. Only what the root code needs: +, -, *, comparisons and shifts
+class BigInteger {
+private:
+    std::vector<uint64_t> mag;  // magnitude, lowest limb first, no leading zero limbs
+    bool negative = false;
+
+    void Trim() {
+        while (!mag.empty() && mag.back() == 0)
+            mag.pop_back();
+        if (mag.empty())
+            negative = false;
+    }
+
+    static int CompareMagnitude(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+        if (a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- != 0;) {
+            if (a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    // a -= b for |a| >= |b|
+    static void SubtractMagnitude(std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+        uint64_t borrow = 0;
+        for (size_t i = 0; i != a.size() && (i < b.size() || borrow != 0); ++i) {
+            unsigned __int128 need = static_cast<unsigned __int128>(i < b.size() ? b[i] : 0) + borrow;
+            borrow = a[i] < need;
+            a[i] = static_cast<uint64_t>(a[i] - need);
+        }
+    }
+
+    // adds b with the sign b_negative, b may be *this
+    void Add(const BigInteger& b, bool b_negative) {
+        if (negative == b_negative) {
+            if (mag.size() < b.mag.size())
+                mag.resize(b.mag.size(), 0);
+            uint64_t carry = 0;
+            for (size_t i = 0; i != mag.size() && (i < b.mag.size() || carry != 0); ++i) {
+                unsigned __int128 sum = static_cast<unsigned __int128>(mag[i]) + (i < b.mag.size() ? b.mag[i] : 0) + carry;
+                mag[i] = static_cast<uint64_t>(sum);
+                carry = static_cast<uint64_t>(sum >> 64);
+            }
+            if (carry != 0)
+                mag.push_back(carry);
+        } else if (CompareMagnitude(mag, b.mag) >= 0) {
+            SubtractMagnitude(mag, b.mag);
+        } else {
+            std::vector<uint64_t> difference = b.mag;
+            SubtractMagnitude(difference, mag);
+            mag = std::move(difference);
+            negative = b_negative;
+        }
+        Trim();
+    }
+public:
+    BigInteger() = default;
+
+    template <typename I, typename = typename std::enable_if<std::is_integral<I>::value>::type>
+    BigInteger(I x) {
+        static_assert(sizeof(I) <= sizeof(uint64_t), "BigInteger: wider builtin integer");
+        if constexpr (std::is_signed<I>::value) {
+            negative = x < 0;
+            // magnitude without overflow for the most negative value
+            mag.push_back(negative ? 0 - static_cast<uint64_t>(x) : static_cast<uint64_t>(x));
+        } else {
+            mag.push_back(x);
+        }
+        Trim();
+    }
+
+    BigInteger& operator += (const BigInteger& b) {
+        Add(b, b.negative);
+        return *this;
+    }
+
+    BigInteger& operator -= (const BigInteger& b) {
+        Add(b, !b.negative);
+        return *this;
+    }
+
+    BigInteger& operator *= (const BigInteger& b) {
+        return *this = *this * b;
+    }
+
+    friend BigInteger operator + (BigInteger a, const BigInteger& b) {
+        return a += b;
+    }
+
+    friend BigInteger operator - (BigInteger a, const BigInteger& b) {
+        return a -= b;
+    }
+
+    friend BigInteger operator * (const BigInteger& a, const BigInteger& b) {
+        BigInteger product;
+        if (a.mag.empty() || b.mag.empty())
+            return product;
+        product.mag.assign(a.mag.size() + b.mag.size(), 0);
+        for (size_t i = 0; i != a.mag.size(); ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j != b.mag.size(); ++j) {
+                unsigned __int128 t = static_cast<unsigned __int128>(a.mag[i]) * b.mag[j] + product.mag[i + j] + carry;
+                product.mag[i + j] = static_cast<uint64_t>(t);
+                carry = static_cast<uint64_t>(t >> 64);
+            }
+            product.mag[i + b.mag.size()] = carry;
+        }
+        product.negative = a.negative != b.negative;
+        product.Trim();
+        return product;
+    }
+
+    BigInteger operator - () const {
+        BigInteger result = *this;
+        if (!result.mag.empty())
+            result.negative = !negative;
+        return result;
+    }
+
+    // multiplies by 2^k
+    BigInteger& operator <<= (size_t k) {
+        if (mag.empty() || k == 0)
+            return *this;
+        size_t limbs = k / 64, bits = k % 64;
+        if (bits != 0) {
+            uint64_t carry = 0;
+            for (uint64_t& x : mag) {
+                uint64_t next = x >> (64 - bits);
+                x = x << bits | carry;
+                carry = next;
+            }
+            if (carry != 0)
+                mag.push_back(carry);
+        }
+        mag.insert(mag.begin(), limbs, 0);
+        return *this;
+    }
+
+    // divides the magnitude by 2^k, rounding toward zero
+    BigInteger& operator >>= (size_t k) {
+        size_t limbs = std::min(k / 64, mag.size()), bits = k % 64;
+        mag.erase(mag.begin(), mag.begin() + limbs);
+        if (bits != 0) {
+            for (size_t i = 0; i != mag.size(); ++i)
+                mag[i] = mag[i] >> bits | (i + 1 < mag.size() ? mag[i + 1] << (64 - bits) : 0);
+        }
+        Trim();
+        return *this;
+    }
+
+    // exponent of the largest power of two dividing a nonzero value
+    size_t TrailingZeros() const {
+        size_t i = 0;
+        while (mag[i] == 0)
+            ++i;
+        return 64 * i + __builtin_ctzll(mag[i]);
+    }
+
+    bool operator == (const BigInteger& b) const {
+        return negative == b.negative && mag == b.mag;
+    }
+
+    bool operator != (const BigInteger& b) const {
+        return !(*this == b);
+    }
+
+    bool operator < (const BigInteger& b) const {
+        if (negative != b.negative)
+            return negative;
+        int order = CompareMagnitude(mag, b.mag);
+        return negative ? order > 0 : order < 0;
+    }
+
+    bool operator > (const BigInteger& b) const {
+        return b < *this;
+    }
+};
+
+// coefficient type the root code computes with: BigInteger for builtin integers
+template <typename T>
+using RootCoefficient = typename std::conditional<std::is_integral<T>::value, BigInteger, T>::type;
+
+// a + b and a * b for interval ends: builtin integers throw std::overflow_error where
+// they would wrap, other types compute as usual
+template <typename T>
+T CheckedAdd(const T& a, const T& b) {
+    if constexpr (std::is_integral_v<T>) {
+        T sum;
+        if (__builtin_add_overflow(a, b, &sum))
+            throw std::overflow_error("Polynomial: root interval end overflow");
+        return sum;
+    } else {
+        return a + b;
+    }
+}
+
+template <typename T>
+T CheckedMul(const T& a, const T& b) {
+    if constexpr (std::is_integral_v<T>) {
+        T product;
+        if (__builtin_mul_overflow(a, b, &product))
+            throw std::overflow_error("Polynomial: root interval end overflow");
+        return product;
+    } else {
+        return a * b;
+    }
+}
+
+// BigInteger coefficients only lose their common power of two, the factor that
+// scaling and bisection bring in
+inline void RemoveContent(std::vector<BigInteger>& a) {
+    size_t shift = std::numeric_limits<size_t>::max();
+    for (const BigInteger& x : a) {
+        if (x != BigInteger())
+            shift = std::min(shift, x.TrailingZeros());
+    }
+    if (shift != std::numeric_limits<size_t>::max() && shift != 0) {
+        for (BigInteger& x : a)
+            x >>= shift;
+    }
+}
+
+// p(2^s x), times 2^(-s deg p) for s < 0 to stay integral, with the content removed;
+// the roots are divided by 2^s
+template <typename T>
+void ScaleArgument(std::vector<T>& p, int s) {
+    size_t k = std::abs(s);
+    for (size_t i = 0; i != p.size(); ++i) {
+        size_t e = k * (s > 0 ? i : p.size() - 1 - i);
+        if constexpr (std::is_same<T, BigInteger>::value)
+            p[i] <<= e;
+        else
+            p[i] *= PowScalar(T(2), e);
+    }
+    RemoveContent(p);
+}
+
+// floor(log2 x) for x > 0
+template <typename T>
+int FloorLog2(T x) {
+    int e = 0;
+    for (; !(x < T(2)); ++e)
+        x /= T(2);
+    for (; x < T(1); --e)
+        x *= T(2);
+    return e;
+}
+
+// smallest b >= 0 with |x| < 2^b for every root up to rounding of the logarithms, from
+// Fujiwara's bound 2 max(|a_(n-1) / a_n|, |a_(n-2) / a_n|^(1/2), ..., |a_0 / 2 a_n|^(1/n))
+template <typename T>
+int RootBoundLog(const std::vector<T>& f) {
+    auto abs = [](const T& x) {
+        return x < T() ? -x : x;
+    };
+    int n = f.size() - 1, lead = FloorLog2(abs(f.back())), b = 0;
+    for (int k = 1; k <= n; ++k) {
+        if (f[n - k] == T())
+            continue;
+        // |a_(n-k) / a_n| < 2^(e + 1), halved once more for the constant term
+        int e = FloorLog2(abs(f[n - k])) - lead + (k == n ? 0 : 1);
+        int root = e >= 0 ? (e + k - 1) / k : -(-e / k);
+        b = std::max(b, root + 1);
+    }
+    return b;
+}
+
+// appends the roots of squarefree p lying in (0, 2^bound_log), p(0) != 0, in increasing
+// order; negate reports them as roots -x of p(-x). Descartes' rule of signs on
+// (x + 1)^n p(1 / (x + 1)) counts the roots in (0, 1) up to an even number, zero or
+// one is decisive, otherwise (0, 1) is bisected into 2^n p(x / 2) and its shift by one.
+// Coefficients are RootCoefficient<T>, interval ends stay in T
+template <typename T>
+void IsolateUnitRoots(const std::vector<T>& f, int bound_log, bool negate, std::vector<RootInterval<T>>& roots) {
+    using W = RootCoefficient<T>;
+    std::vector<W> p(f.begin(), f.end());
+    ScaleArgument(p, bound_log);
+    // (c, c + 1) / 2^k of the scaled variable, or the point c / 2^k when exact
+    struct Cell {
+        std::vector<W> p;
+        T c;
+        int k;
+        bool exact;
+    };
+    auto emit = [&](const T& left, const T& right, int k) {
+        RootInterval<T> root {negate ? -right : left, negate ? -left : right, k - bound_log};
+        roots.push_back(root);
+    };
+    std::vector<Cell> cells;
+    cells.push_back(Cell {std::move(p), T(), 0, false});
+    while (!cells.empty()) {
+        Cell cell = std::move(cells.back());
+        cells.pop_back();
+        if (cell.exact) {
+            emit(cell.c, cell.c, cell.k);
+            continue;
+        }
+        std::vector<W> test(cell.p.rbegin(), cell.p.rend());
+        TaylorShiftVector(test, W(1));
+        int variations = SignVariations(test, 2);
+        if (variations == 0)
+            continue;
+        if (variations == 1) {
+            emit(cell.c, cell.c + T(1), cell.k);
+            continue;
+        }
+        T c = CheckedMul(cell.c, T(2));
+        std::vector<W> left = std::move(cell.p);
+        ScaleArgument(left, -1);
+        std::vector<W> right = left;
+        TaylorShiftVector(right, W(1));
+        T mid = CheckedAdd(c, T(1));
+        bool exact = right[0] == W();
+        if (exact)
+            right.erase(right.begin());  // root exactly at the midpoint
+        // pushed in reverse so that the roots come out in increasing order
+        cells.push_back(Cell {std::move(right), mid, cell.k + 1, false});
+        if (exact)
+            cells.push_back(Cell {{}, mid, cell.k + 1, true});
+        cells.push_back(Cell {std::move(left), c, cell.k + 1, false});
+    }
+}
+
+// starting points for Aberth iteration on the circles of the Newton polygon: an edge of the
+// upper convex hull of (i, log |a_i|) from i to j carries j - i roots of modulus about
+// (|a_i| / |a_j|)^(1 / (j - i)); a[0] and a.back() must be nonzero
+inline std::vector<std::complex<double>> AberthStart(const std::vector<std::complex<double>>& a) {
+    size_t n = a.size() - 1;
+    std::vector<size_t> hull;
+    std::vector<double> logs(a.size());
+    for (size_t i = 0; i <= n; ++i) {
+        if (a[i] == 0.0)
+            continue;
+        logs[i] = std::log(std::abs(a[i]));
+        // pops the last vertex while it is not above the segment to the new one
+        while (hull.size() >= 2) {
+            size_t p = hull[hull.size() - 2], q = hull.back();
+            if ((logs[q] - logs[p]) * double(i - p) > (logs[i] - logs[p]) * double(q - p))
+                break;
+            hull.pop_back();
+        }
+        hull.push_back(i);
+    }
+    const double pi = std::acos(-1.0), sigma = 0.7;
+    std::vector<std::complex<double>> start;
+    start.reserve(n);
+    for (size_t h = 1; h < hull.size(); ++h) {
+        size_t i = hull[h - 1], m = hull[h] - i;
+        double radius = std::exp((logs[i] - logs[hull[h]]) / double(m));
+        for (size_t k = 0; k != m; ++k)
+            start.push_back(std::polar(radius, 2 * pi * k / m + 2 * pi * i / n + sigma));
+    }
+    return start;
+}
+
+// Newton correction f(z) / f'(z); radius gets n (|f(z)| + rounding) / |f'(z)|, a disk around z
+// that holds a root, converged is set when |f(z)| is below the rounding error. For |z| > 1
+// the reversal q is evaluated at w = 1 / z instead, f / f' = z q(w) / (n q(w) - w q'(w))
+inline std::complex<double> NewtonCorrection(const std::vector<std::complex<double>>& f,
+                                             const std::vector<std::complex<double>>& reversed,
+                                             std::complex<double> z, double& radius, bool& converged) {
+    size_t n = f.size() - 1;
+    bool outside = std::abs(z) > 1;
+    const std::vector<std::complex<double>>& a = outside ? reversed : f;
+    std::complex<double> x = outside ? 1.0 / z : z, value = a[n], derivative = 0;
+    double magnitude = std::abs(a[n]), modulus = std::abs(x);
+    for (size_t i = n; i-- != 0;) {
+        derivative = derivative * x + value;
+        value = value * x + a[i];
+        magnitude = magnitude * modulus + std::abs(a[i]);
+    }
+    double error = 2.0 * (n + 1) * std::numeric_limits<double>::epsilon() * magnitude;
+    converged = std::abs(value) <= error;
+    std::complex<double> denominator = outside ? double(n) * value - x * derivative : derivative;
+    double scale = outside ? std::abs(z) : 1.0;
+    if (denominator == 0.0) {
+        // critical point, step off it
+        radius = std::numeric_limits<double>::infinity();
+        return std::complex<double>(1e-8 * (1 + std::abs(z)), 0);
+    }
+    radius = n * (std::abs(value) + error) / std::abs(denominator) * scale;
+    return (outside ? z : 1.0) * value / denominator;
+}
+
+// adds sum 1 / (x + iy - z_j) over [from, to) into (sum_re, sum_im), split real and
+// imaginary arrays keep the loop vectorizable
+inline void InverseDistanceSum(const double* re, const double* im, size_t from, size_t to,
+                               double x, double y, double& sum_re, double& sum_im) {
+    double sr = 0, si = 0;
+    for (size_t j = from; j < to; ++j) {
+        double dx = x - re[j], dy = y - im[j], inv = 1.0 / (dx * dx + dy * dy);
+        sr += dx * inv;
+        si -= dy * inv;
+    }
+    sum_re += sr;
+    sum_im += si;
+}
+
+// reads one coefficient with std::from_chars, a leading '-' included; returns the end of
+// the number or nullptr when there is none
+template <typename T>
+const char* ParseCoefficient(const char* first, const char* last, T& value) {
+    static_assert(std::is_arithmetic<T>::value, "no text format for this coefficient type");
+    std::from_chars_result result = std::from_chars(first, last, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+template <uint64_t Mod>
+const char* ParseCoefficient(const char* first, const char* last, ModInt<Mod>& value) {
+    bool negative = first != last && *first == '-';
+    unsigned long long residue;
+    std::from_chars_result result = std::from_chars(first + negative, last, residue);
+    if (result.ec != std::errc())
+        return nullptr;
+    value = negative ? -ModInt<Mod>(residue) : ModInt<Mod>(residue);
+    return result.ptr;
+}
+
+inline bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// parses all of [first, last) as either the operator << form, e.g. x^3+2*x^2-x+3 or 0,
+// or a coefficient list [c0,c1,...] from lowest degree; blanks between tokens are
+// allowed. Terms go straight into the coefficient array sized by the first (highest)
+// term, repeated or ascending degrees are added up. Throws std::invalid_argument
+template <typename T>
+std::vector<T> ParsePolynomial(const char* first, const char* last) {
+    const char* begin = first;
+    auto fail = [begin](const char* where) {
+        throw std::invalid_argument("Polynomial: parse error at offset " + std::to_string(where - begin));
+    };
+    auto skip = [&first, last]() {
+        while (first != last && IsBlank(*first))
+            ++first;
+    };
+    std::vector<T> coef;
+    skip();
+    if (first != last && *first == '[') {
+        ++first;
+        const char* close = std::find(first, last, ']');
+        if (close == last)
+            fail(last);
+        coef.reserve(std::count(first, close, ',') + 1);
+        skip();
+        while (first != close) {
+            coef.emplace_back();
+            first = ParseCoefficient(first, close, coef.back());
+            if (!first)
+                fail(close);
+            skip();
+            if (first != close && *first++ != ',')
+                fail(first - 1);
+            skip();
+        }
+        first = close + 1;
+    } else {
+        for (bool leading = true; leading || first != last; leading = false) {
+            bool negative = false;
+            if (first != last && (*first == '+' || *first == '-')) {
+                negative = *first++ == '-';
+                skip();
+            } else if (!leading) {
+                fail(first);
+            }
+            T c = T(1);
+            bool monomial = true;
+            if (first != last && *first != 'x') {
+                if (*first == '-')
+                    fail(first);
+                // a sign right before the number is parsed with it, which keeps the
+                // most negative integer in range
+                const char* number = negative && first[-1] == '-' ? first - 1 : first;
+                const char* end = ParseCoefficient(number, last, c);
+                if (!end)
+                    fail(first);
+                if (number != first)
+                    negative = false;
+                first = end;
+                skip();
+                monomial = first != last && *first == '*';
+                if (monomial) {
+                    ++first;
+                    skip();
+                }
+            }
+            size_t degree = 0;
+            if (monomial) {
+                if (first == last || *first != 'x')
+                    fail(first);
+                ++first;
+                skip();
+                degree = 1;
+                if (first != last && *first == '^') {
+                    ++first;
+                    skip();
+                    std::from_chars_result result = std::from_chars(first, last, degree);
+                    if (result.ec != std::errc())
+                        fail(first);
+                    first = result.ptr;
+                    skip();
+                }
+            }
+            if (degree >= coef.size())
+                coef.resize(degree + 1, T());
+            coef[degree] += negative ? -c : c;
+        }
+    }
+    skip();
+    if (first != last)
+        fail(first);
+    return coef;
+}
+
+// coefficient types with a locale-free std::to_chars form equal to their operator <<
+template <typename T>
+struct HasCharsFormat : std::integral_constant<bool, std::is_floating_point<T>::value ||
+    (std::is_integral<T>::value && sizeof(T) > 1 && !std::is_same<T, wchar_t>::value &&
+     !std::is_same<T, char16_t>::value && !std::is_same<T, char32_t>::value)> {};
+
+template <uint64_t Mod>
+struct HasCharsFormat<ModInt<Mod>> : std::true_type {};
+
+// upper bound of the characters FormatCoefficient writes
+template <typename T>
+size_t CoefficientChars(int precision) {
+    if constexpr (std::is_floating_point<T>::value)
+        return std::max(precision, std::numeric_limits<T>::max_digits10) + 12;  // sign, point, exponent
+    else if constexpr (std::is_integral<T>::value)
+        return std::numeric_limits<T>::digits10 + 3;
+    else
+        return std::numeric_limits<uint64_t>::digits10 + 2;
+}
+
+// writes value at first, floating point with %g-like precision or, when negative, the
+// shortest text that reads back exactly
+template <typename T>
+char* FormatCoefficient(char* first, char* last, const T& value, int precision) {
+    if constexpr (std::is_floating_point<T>::value) {
+        if (precision >= 0)
+            return std::to_chars(first, last, value, std::chars_format::general, precision).ptr;
+    }
+    return std::to_chars(first, last, value).ptr;
+}
+
+template <uint64_t Mod>
+char* FormatCoefficient(char* first, char* last, const ModInt<Mod>& value, int) {
+    return std::to_chars(first, last, value.Value()).ptr;
+}
+
+// appends coef in the operator << form or, with list set, as [c0,c1,...] to buffer. The
+// buffer is grown once to an upper bound of the text and trimmed after the single pass
+template <typename T>
+void FormatPolynomial(const std::vector<T>& coef, bool list, int precision, std::string& buffer) {
+    size_t start = buffer.size();
+    if (coef.empty()) {
+        buffer += list ? "[]" : "0";
+        return;
+    }
+    // a term is at most sign, coefficient, "*x^" and the exponent
+    size_t term = CoefficientChars<T>(precision) + 4 + std::numeric_limits<size_t>::digits10 + 1;
+    buffer.resize(start + coef.size() * term + 2);
+    char* out = &buffer[start];
+    char* last = &buffer[0] + buffer.size();
+    if (list) {
+        *out++ = '[';
+        for (size_t i = 0; i != coef.size(); ++i) {
+            if (i != 0)
+                *out++ = ',';
+            out = FormatCoefficient(out, last, coef[i], precision);
+        }
+        *out++ = ']';
+    } else {
+        // same decisions as operator <<: coefficients 1 and -1 are left out before x
+        size_t deg = coef.size() - 1;
+        for (size_t i = deg + 1; i-- != 0;) {
+            const T& c = coef[i];
+            if (c == T(0))
+                continue;
+            bool one = c == T(1), minus_one = c == T(-1);
+            if (i != 0 && minus_one) {
+                *out++ = '-';
+            } else if (i != 0 && one) {
+                if (i != deg)
+                    *out++ = '+';
+            } else {
+                // '+' unless the text of the coefficient starts with its own sign, which
+                // ModInt(-1) = Mod - 1 does not
+                char* begin = out;
+                if (i != deg)
+                    *out++ = '+';
+                out = FormatCoefficient(out, last, c, precision);
+                if (i != deg && begin[1] == '-') {
+                    std::memmove(begin, begin + 1, out - begin - 1);
+                    --out;
+                }
+                if (i != 0)
+                    *out++ = '*';
+            }
+            if (i != 0) {
+                *out++ = 'x';
+                if (i > 1) {
+                    *out++ = '^';
+                    out = std::to_chars(out, last, i).ptr;
+                }
+            }
+        }
+    }
+    buffer.resize(out - &buffer[0]);
+}
+
+}  // namespace polynomial_detail
+
+template <typename T>
+class Polynomial {
+private:
+    std::vector<T> coef;
+
+    // delete leading non-significant zeros
+    void Delete_Front_Zeros() {
+        while (!coef.empty() && coef.back() == T())
+            coef.pop_back();
+    }
+
+    // f / gcd(f, f'), every distinct root once
+    std::vector<T> SquareFreePart() const {
+        Polynomial<T> derivative = *this;
+        derivative.Derivative();
+        Polynomial<T> g = (*this, derivative);
+        if (g.Degree() <= 0)
+            return coef;
+        return (*this / g).coef;
+    }
+public:
+    // initialize polynomial with vector of coefficients
+    Polynomial(const std::vector<T>& v) : coef(v) {
+        Delete_Front_Zeros();
+    }
+
+    Polynomial(std::vector<T>&& v) : coef(std::move(v)) {
+        Delete_Front_Zeros();
+    }
+
+    // initialize constant polynomial
+    Polynomial(T c = T()) {
+        if (c != T())
+            coef.push_back(c);
+    }
+
+    // initialize polynomial with the pair of iterators
+    template <typename Iter>
+    Polynomial(Iter first, Iter last) {
+        while (first != last) {
+            coef.push_back(*first++);
+        }
+        Delete_Front_Zeros();
+    }
+    
+    // returns degree of polynomial or -1 if it is zero polynomial
+    int Degree() const {
+        for (int i = coef.size() - 1; i >= 0; --i) {
+            if (coef[i] != T())
+                return i;
+        }
+        return -1;
+    }
+
+    // returns coefficient before this degree
+    T operator[] (size_t degree) const {
+        if (coef.size() > degree)
+            return coef[degree];
+        else
+            return T();  // returns default value if requested degree is higher than max degree
+    }
+
+    // returns true if two polynomials are equal, false otherwise
+    bool operator == (const Polynomial<T>& other) const {
+        int fd = Degree();
+        int sd = other.Degree();
+        if (fd != sd) {
+            return false;
+        } else {
+            for (; fd >= 0; --fd) {
+                if ((*this)[fd] != other[fd]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    // returns true if two polynomials are not equal, false otherwise
+    bool operator != (const Polynomial<T>& other) const {
+        return !(*this == other);
+    }
+
+    // sum of two polynomials
+    Polynomial<T> operator + (const Polynomial<T>& other) const {
+        size_t pol_size = std::max(coef.size(), other.coef.size());
+        std::vector<T> pol(pol_size, T());  // resizing with default values
+        for (size_t i = 0; i != pol_size; ++i)
+            pol[i] = (*this)[i] + other[i];
+        return Polynomial<T> {pol};
+    }
+
+    // difference of two polynomials
+    Polynomial<T> operator - (const Polynomial<T>& other) const {  
+        size_t pol_size = std::max(coef.size(), other.coef.size());
+        std::vector<T> pol(pol_size, T());
+        for (size_t i = 0; i != pol_size; ++i)
+            pol[i] = (*this)[i] - other[i];
+        return Polynomial<T> {pol};
+    }
+
+    // product of two polynomials
+    Polynomial<T> operator * (const Polynomial<T>& other) const {  
+        if (this == &other)
+            return Square();  // p * p
+        return Polynomial<T> {polynomial_detail::Multiply(coef, other.coef)};
+    }
+
+    // sum of two polynomials
+    Polynomial<T>& operator += (const Polynomial<T>& other) {
+        size_t pol_size = std::max(coef.size(), other.coef.size());
+        coef.resize(pol_size, T());
+        for (size_t i = 0; i != pol_size; ++i)
+            coef[i] += other[i];
+        Delete_Front_Zeros();
+        return *this;
+    }
+
+    // difference of two polynomials
+    Polynomial<T>& operator -= (const Polynomial<T>& other) {
+        size_t pol_size = std::max(coef.size(), other.coef.size());
+        coef.resize(pol_size, T());
+        for (size_t i = 0; i != pol_size; ++i)
+            coef[i] -= other[i];
+        Delete_Front_Zeros();
+        return *this;
+    }
+
+    // product of two polynomials
+    Polynomial& operator *= (const Polynomial<T>& other) {
+        Polynomial poly = *this * other;
+        *this = poly;
+        return *this;
+    }
+
+    // square of polynomial, about half the multiplications of a generic product
+    Polynomial<T> Square() const {
+        return Polynomial<T> {polynomial_detail::Square(coef)};
+    }
+
+    // calculates f(value)
+    T operator() (T value) const {  
+        T ans = T();
+        for (int i = coef.size() - 1; i >= 0; --i)
+            ans = coef[i] + ans * value;  // Horner's method
+        return ans;
+    }
+
+    // calculates f(value), f'(value), ..., f^(k)(value) in one pass
+    std::vector<T> Derivatives(T value, size_t k) const {
+        // d[j] accumulates the j-th Taylor coefficient f^(j)(value) / j!
+        std::vector<T> d(k + 1, T());
+        for (int i = coef.size() - 1; i >= 0; --i) {
+            size_t top = std::min(k, coef.size() - 1 - i);
+            for (size_t j = top; j != 0; --j)
+                d[j] = d[j - 1] + d[j] * value;
+            d[0] = coef[i] + d[0] * value;
+        }
+        T factorial = T(1);
+        for (size_t j = 2; j <= k; ++j) {
+            factorial = factorial * T(j);
+            d[j] = d[j] * factorial;
+        }
+        return d;
+    }
+
+    // replaces polynomial with its derivative without reallocation
+    Polynomial<T>& Derivative() {
+        if (coef.empty())
+            return *this;
+        for (size_t i = 1; i != coef.size(); ++i)
+            coef[i - 1] = coef[i] * T(i);
+        coef.pop_back();
+        Delete_Front_Zeros();
+        return *this;
+    }
+
+    // replaces polynomial with its antiderivative (zero constant term); needs 1 .. deg + 1
+    // invertible, otherwise throws std::domain_error and leaves the polynomial unchanged
+    Polynomial<T>& Integral() {
+        static_assert(!std::numeric_limits<T>::is_integer, "Polynomial: Integral needs a field");
+        if (coef.empty())
+            return *this;
+        for (size_t i = 1; i <= coef.size(); ++i) {
+            if (T(i) == T())
+                throw std::domain_error("Polynomial: integral needs characteristic above the degree + 1");
+        }
+        coef.push_back(T());  // the only growth, amortized by vector capacity
+        for (size_t i = coef.size() - 1; i != 0; --i)
+            coef[i] = coef[i - 1] / T(i);
+        coef[0] = T();
+        Delete_Front_Zeros();
+        return *this;
+    }
+
+    // power series 1 / f mod x^n, constant term must be invertible
+    Polynomial<T> Inverse(size_t n) const {
+        return Polynomial<T> {polynomial_detail::SeriesInverse(coef, n)};
+    }
+
+    // power series log f mod x^n, constant term must be 1
+    Polynomial<T> Log(size_t n) const {
+        return Polynomial<T> {polynomial_detail::SeriesLog(coef, n)};
+    }
+
+    // power series exp f mod x^n, constant term must be 0
+    Polynomial<T> Exp(size_t n) const {
+        return Polynomial<T> {polynomial_detail::SeriesExp(coef, n)};
+    }
+
+    // power series sqrt f mod x^n, lowest term must be an even power with a square coefficient
+    Polynomial<T> Sqrt(size_t n) const {
+        return Polynomial<T> {polynomial_detail::SeriesSqrt(coef, n)};
+    }
+
+    // power series f^k mod x^n
+    Polynomial<T> Pow(unsigned long long k, size_t n) const {
+        return Polynomial<T> {polynomial_detail::SeriesPow(coef, k, n)};
+    }
+
+    // disjoint isolating intervals of the real roots in increasing order, see RootInterval.
+    // Descartes' rule of signs with bisection on the squarefree part, for integer and
+    // exact rational T; coefficients grow by up to deg f bits per bisection level, builtin
+    // integers are therefore isolated on polynomial_detail::BigInteger and only interval
+    // ends that leave the range of T throw std::overflow_error
+    std::vector<RootInterval<T>> IsolateRealRoots() const {
+        std::vector<T> f = SquareFreePart();
+        std::vector<RootInterval<T>> roots, negative;
+        if (f.size() < 2)
+            return roots;
+        bool zero_root = f[0] == T();
+        if (zero_root)
+            f.erase(f.begin());
+        polynomial_detail::RemoveContent(f);
+        int bound_log = polynomial_detail::RootBoundLog(f);
+        std::vector<T> reflected = f;
+        for (size_t i = 1; i < reflected.size(); i += 2)
+            reflected[i] = polynomial_detail::CheckedMul(reflected[i], T(-1));
+        polynomial_detail::IsolateUnitRoots(reflected, bound_log, true, negative);
+        roots.assign(negative.rbegin(), negative.rend());
+        if (zero_root)
+            roots.push_back(RootInterval<T> {T(), T(), 0});
+        polynomial_detail::IsolateUnitRoots(f, bound_log, false, roots);
+        return roots;
+    }
+
+    // bisects intervals from IsolateRealRoots until each is exact or has scale >= bits,
+    // that is at most 2^-bits wide; f is moved onto (0, 1) of each interval exactly
+    void RefineRealRoots(std::vector<RootInterval<T>>& roots, int bits) const {
+        using W = polynomial_detail::RootCoefficient<T>;
+        std::vector<T> f = SquareFreePart();
+        for (RootInterval<T>& root : roots) {
+            if (root.left == root.right || root.scale >= bits)
+                continue;
+            std::vector<W> p(f.begin(), f.end());
+            polynomial_detail::ScaleArgument(p, -root.scale);
+            polynomial_detail::TaylorShiftVector(p, W(root.left));
+            while (p[0] == W())
+                p.erase(p.begin());  // exact root at the left end
+            while (root.scale < bits) {
+                // roots in (0, 1/2) move to (0, 1), those in (1/2, 1) to (1, 2)
+                polynomial_detail::ScaleArgument(p, -1);
+                std::vector<W> right = p;
+                polynomial_detail::TaylorShiftVector(right, W(1));
+                root.left = polynomial_detail::CheckedMul(root.left, T(2));
+                ++root.scale;
+                if (right[0] == W()) {
+                    root.left = root.right = polynomial_detail::CheckedAdd(root.left, T(1));
+                    break;
+                }
+                if ((right[0] < W()) == (p[0] < W())) {
+                    p = std::move(right);
+                    root.left = polynomial_detail::CheckedAdd(root.left, T(1));
+                }
+                root.right = root.left + T(1);
+            }
+        }
+    }
+
+    // parses the operator << form (x^3+2*x^2-x+3) or a coefficient list [c0,c1,...]
+    // from lowest degree, throws std::invalid_argument on malformed text
+    static Polynomial<T> FromString(std::string_view text) {
+        return Polynomial<T> {polynomial_detail::ParsePolynomial<T>(text.data(), text.data() + text.size())};
+    }
+
+    // appends the text of the polynomial to buffer: the operator << form, or the compact
+    // [c0,c1,...] list; floating point coefficients use the shortest exact text, so
+    // FromString reads both forms back unchanged
+    void FormatTo(std::string& buffer, PolynomialFormat format = PolynomialFormat::Expression) const {
+        polynomial_detail::FormatPolynomial(coef, format == PolynomialFormat::List, -1, buffer);
+    }
+
+    std::string ToString(PolynomialFormat format = PolynomialFormat::Expression) const {
+        std::string buffer;
+        FormatTo(buffer, format);
+        return buffer;
+    }
+
+    // coefficients from lowest to highest degree without leading zeros
+    const std::vector<T>& Coefficients() const {
+        return coef;
+    }
+
+    typename std::vector<T>::const_iterator begin() const {
+        return coef.begin();
+    }
+
+    typename std::vector<T>::const_iterator end() const {
+        return coef.end();
+    }
+
+    // shifts argument in place: f(x) -> f(x + a), classical O(n^2) scheme
+    Polynomial<T>& TaylorShiftInPlace(T a) {
+        polynomial_detail::TaylorShiftClassical(coef.data(), coef.size(), a);
+        Delete_Front_Zeros();
+        return *this;
+    }
+
+    // returns f(x + a)
+    Polynomial<T> TaylorShift(T a) const {
+        Polynomial<T> result = *this;
+        // small degrees are faster classically
+        if (coef.size() < 64) {
+            result.TaylorShiftInPlace(a);
+            return result;
+        }
+        // the convolution divides by (n - 1)!, exactly only in fields of characteristic
+        // zero; integers, floating point, whose factorials lose all precision and overflow
+        // past 170, prime fields and types of unknown exactness split into blocks instead
+        if (!std::numeric_limits<T>::is_exact || std::numeric_limits<T>::is_integer) {
+            polynomial_detail::TaylorShiftVector(result.coef, a);
+            return result;
+        }
+        // convolution of (coef[j] * j!) reversed with a^k / k!, then divide by i!
+        size_t n = coef.size();
+        std::vector<T> factorial(n, T(1));
+        for (size_t i = 1; i != n; ++i)
+            factorial[i] = factorial[i - 1] * T(i);
+        std::vector<T> weighted(n), powers(n);
+        T power = T(1);
+        for (size_t i = 0; i != n; ++i) {
+            weighted[n - 1 - i] = coef[i] * factorial[i];
+            powers[i] = power / factorial[i];
+            power = power * a;
+        }
+        Polynomial<T> conv = Polynomial<T>{weighted} * Polynomial<T>{powers};
+        for (size_t i = 0; i != n; ++i)
+            result.coef[i] = conv[n - 1 - i] / factorial[i];
+        result.Delete_Front_Zeros();
+        return result;
+    }
+
+    // returns composition
+    Polynomial<T> operator & (const Polynomial<T>& other) const {  
+        if (other.Degree() == 1 && other[1] == T(1))
+            return TaylorShift(other[0]);  // f(x + a) has a dedicated algorithm
+        Polynomial<T> composition;
+        for (int i = coef.size() - 1; i >= 0; --i) {
+            composition *= other;  // Horner's method
+            composition += Polynomial<T>{coef[i]};
+        }
+        return composition;
+    }
+
+    // divides one polynomial by another
+    Polynomial<T> operator / (const Polynomial<T>& other) const {
+        std::vector<T> quotient, remainder;
+        polynomial_detail::DivMod(coef, other.coef, quotient, remainder);
+        return Polynomial<T> {std::move(quotient)};
+    }
+
+    // returns remainder
+    Polynomial<T> operator % (const Polynomial<T>& other) const {  
+        std::vector<T> quotient, remainder;
+        polynomial_detail::DivMod(coef, other.coef, quotient, remainder);
+        return Polynomial<T> {std::move(remainder)};
+    }
+
+    // returns g with g * f = 1 mod modulus, throws if they are not coprime
+    Polynomial<T> InverseMod(const Polynomial<T>& modulus) const {
+        std::vector<T> s, remainder, quotient;
+        polynomial_detail::DivMod(coef, modulus.coef, quotient, remainder);
+        std::vector<T> g = polynomial_detail::ExtendedGcdVector(remainder, modulus.coef, &s, nullptr);
+        if (g.size() != 1)
+            throw std::domain_error("Polynomial: not invertible modulo a common factor");
+        return Polynomial<T> {std::move(s)};
+    }
+
+    // returns PolynomialGCD (greatest common divisor)
+    Polynomial<T> operator , (const Polynomial<T>& other) const {  
+        static_assert(std::numeric_limits<T>::is_integer || std::is_floating_point<T>::value ||
+            polynomial_detail::IsField<T>::value, "Polynomial: gcd needs builtin integers or a field");
+        if constexpr (std::numeric_limits<T>::is_integer)
+            return Polynomial<T> {polynomial_detail::IntegerGcd(coef, other.coef)};  // division would truncate
+        if constexpr (polynomial_detail::IsField<T>::value)
+            return Polynomial<T> {polynomial_detail::GcdVector(coef, other.coef)};  // exact fields like ModInt
+        Polynomial<T> first = *this, second = other;
+        if (first.Degree() < second.Degree()) {
+            std::swap(first, second);
+        }
+        while (second.Degree() > 0) {
+            Polynomial<T> tmp = second;
+            first = first % second;
+            second = first;
+            first = tmp;
+        }
+        if (second != T(0))
+            return Polynomial(T(1));
+        first = first / first[first.Degree()];
+        return first;
+    }
+};
+
+// greatest common divisor: monic over a field, subquadratic by half-GCD;
+// content times primitive part with positive leading coefficient over the integers
+template <typename T>
+Polynomial<T> Gcd(const Polynomial<T>& a, const Polynomial<T>& b) {
+    static_assert(std::numeric_limits<T>::is_integer || std::is_floating_point<T>::value ||
+        polynomial_detail::IsField<T>::value, "Polynomial: gcd needs builtin integers or a field");
+    if constexpr (std::numeric_limits<T>::is_integer)
+        return Polynomial<T> {polynomial_detail::IntegerGcd(a.Coefficients(), b.Coefficients())};
+    else
+        return Polynomial<T> {polynomial_detail::GcdVector(a.Coefficients(), b.Coefficients())};
+}
+
+// monic gcd over a field with Bezout cofactors s * f + t * g = gcd from the half-GCD
+// matrices; pass nullptr for a cofactor that is not needed to skip computing it
+template <typename T>
+Polynomial<T> ExtendedGCD(const Polynomial<T>& f, const Polynomial<T>& g,
+                          typename polynomial_detail::NonDeduced<Polynomial<T>*>::type s,
+                          typename polynomial_detail::NonDeduced<Polynomial<T>*>::type t) {
+    std::vector<T> vs, vt;
+    Polynomial<T> result {polynomial_detail::ExtendedGcdVector(f.Coefficients(), g.Coefficients(),
+                                                              s ? &vs : nullptr, t ? &vt : nullptr)};
+    if (s)
+        *s = Polynomial<T> {std::move(vs)};
+    if (t)
+        *t = Polynomial<T> {std::move(vt)};
+    return result;
+}
+
+// resultant of f and g: half-GCD quotient sequence over fields, two-prime
+// modular computation with CRT reconstruction for integer T (result must fit in T)
+template <typename T>
+T Resultant(const Polynomial<T>& f, const Polynomial<T>& g) {
+    if constexpr (std::numeric_limits<T>::is_integer)
+        return polynomial_detail::IntegerResultant(f.Coefficients(), g.Coefficients());
+    else
+        return polynomial_detail::FieldResultant(f.Coefficients(), g.Coefficients());
+}
+
+// discriminant (-1)^(n(n-1)/2) Res(f, f') / lc(f), zero for constants
+template <typename T>
+T Discriminant(const Polynomial<T>& f) {
+    int n = f.Degree();
+    if (n < 1)
+        return T();
+    Polynomial<T> derivative = f;
+    derivative.Derivative();
+    T result = Resultant(f, derivative) / f[n];
+    return (n * (n - 1) / 2) % 2 == 0 ? result : -result;
+}
+
+// product of two polynomials mod x^n
+template <typename T>
+Polynomial<T> MulLow(const Polynomial<T>& a, const Polynomial<T>& b, size_t n) {
+    return Polynomial<T> {polynomial_detail::LowProduct(a.Coefficients(), b.Coefficients(), n)};
+}
+
+// truncated product for power series code, same as MulLow
+template <typename T>
+Polynomial<T> MulTrunc(const Polynomial<T>& a, const Polynomial<T>& b, size_t n) {
+    return MulLow(a, b, n);
+}
+
+// product of two polynomials divided by x^n, lower coefficients are never computed
+template <typename T>
+Polynomial<T> MulHigh(const Polynomial<T>& a, const Polynomial<T>& b, size_t n) {
+    return Polynomial<T> {polynomial_detail::HighProduct(a.Coefficients(), b.Coefficients(), n)};
+}
+
+// coefficients of a * b at degrees deg(b) .. deg(a), zero if deg(a) < deg(b)
+template <typename T>
+Polynomial<T> MiddleProduct(const Polynomial<T>& a, const Polynomial<T>& b) {
+    return Polynomial<T> {polynomial_detail::MiddleProduct(a.Coefficients(), b.Coefficients())};
+}
+
+// precomputed reducer modulo fixed f: stores 1 / rev(f) so that every
+// reduction costs two truncated products instead of a long division
+template <typename T>
+class PolynomialModulus {
+private:
+    std::vector<T> mod;
+    std::vector<T> inv_rev;  // 1 / rev(f) mod x^deg(f)
+
+    // reduces a with deg(a) < 2 * deg(f) in place
+    void ReduceBlock(std::vector<T>& a, size_t offset) const {
+        size_t n = mod.size() - 1, m = a.size() - offset - n;
+        std::vector<T> ra(a.rbegin(), a.rbegin() + m);
+        std::vector<T> q = polynomial_detail::LowProduct(ra, inv_rev, m);
+        std::reverse(q.begin(), q.end());
+        std::vector<T> qf = polynomial_detail::LowProduct(mod, q, n);
+        for (size_t i = 0; i != n; ++i)
+            a[offset + i] -= qf[i];
+        a.resize(offset + n);
+    }
+
+    std::vector<T> ReduceVector(std::vector<T> a) const {
+        size_t n = mod.size() - 1;
+        if (n == 0)
+            return {};  // a nonzero constant divides everything
+        // peel off the top 2 * deg(f) coefficients until the rest fits
+        while (a.size() > n) {
+            size_t offset = a.size() > 2 * n ? a.size() - 2 * n : 0;
+            ReduceBlock(a, offset);
+        }
+        return a;
+    }
+public:
+    PolynomialModulus(const Polynomial<T>& f) : mod(f.Coefficients()) {
+        if (mod.empty())
+            throw std::domain_error("PolynomialModulus: zero modulus");
+        std::vector<T> rev(mod.rbegin(), mod.rend());
+        inv_rev = polynomial_detail::SeriesInverse(rev, mod.size() - 1);
+    }
+
+    Polynomial<T> Modulus() const {
+        return Polynomial<T> {mod};
+    }
+
+    int Degree() const {
+        return mod.size() - 1;
+    }
+
+    // returns a mod f
+    Polynomial<T> Reduce(const Polynomial<T>& a) const {
+        return Polynomial<T> {ReduceVector(a.Coefficients())};
+    }
+
+    // returns a * b mod f, operands are expected to be reduced
+    Polynomial<T> MulMod(const Polynomial<T>& a, const Polynomial<T>& b) const {
+        if (&a == &b)
+            return SquareMod(a);
+        return Polynomial<T> {ReduceVector(polynomial_detail::Multiply(a.Coefficients(), b.Coefficients()))};
+    }
+
+    // returns a * a mod f
+    Polynomial<T> SquareMod(const Polynomial<T>& a) const {
+        return Polynomial<T> {ReduceVector(polynomial_detail::Square(a.Coefficients()))};
+    }
+
+    // returns base^e mod f, exponent is given by 64-bit limbs from lowest to highest;
+    // sliding window exponentiation with precomputed odd powers
+    Polynomial<T> Pow(const Polynomial<T>& base, const std::vector<uint64_t>& e) const {
+        int bits = 64 * e.size();
+        while (bits > 0 && !(e[(bits - 1) / 64] >> ((bits - 1) % 64) & 1))
+            --bits;
+        auto bit = [&e](int i) {
+            return int(e[i / 64] >> (i % 64) & 1);
+        };
+        Polynomial<T> result = Reduce(Polynomial<T>(T(1)));
+        if (bits == 0)
+            return result;
+        int window = bits > 512 ? 5 : bits > 128 ? 4 : bits > 24 ? 3 : 1;
+        // odd[i] = base^(2i + 1)
+        std::vector<Polynomial<T>> odd(size_t(1) << (window - 1));
+        odd[0] = Reduce(base);
+        if (odd.size() > 1) {
+            Polynomial<T> square = SquareMod(odd[0]);
+            for (size_t i = 1; i != odd.size(); ++i)
+                odd[i] = MulMod(odd[i - 1], square);
+        }
+        for (int i = bits - 1; i >= 0;) {
+            if (!bit(i)) {
+                result = SquareMod(result);
+                --i;
+                continue;
+            }
+            // longest window ending with a set bit
+            int j = std::max(i - window + 1, 0);
+            while (!bit(j))
+                ++j;
+            int value = 0;
+            for (int k = i; k >= j; --k) {
+                value = 2 * value + bit(k);
+                result = SquareMod(result);
+            }
+            result = MulMod(result, odd[value / 2]);
+            i = j - 1;
+        }
+        return result;
+    }
+
+    Polynomial<T> Pow(const Polynomial<T>& base, unsigned long long e) const {
+        return Pow(base, std::vector<uint64_t>{e});
+    }
+};
+
+// returns base^e mod modulus using the precomputed reducer
+template <typename T, typename E>
+Polynomial<T> PowMod(const Polynomial<T>& base, const E& e, const PolynomialModulus<T>& modulus) {
+    return modulus.Pow(base, e);
+}
+
+// returns base^e mod modulus, prefer the PolynomialModulus overload for repeated calls
+template <typename T, typename E>
+Polynomial<T> PowMod(const Polynomial<T>& base, const E& e, const Polynomial<T>& modulus) {
+    return PolynomialModulus<T>(modulus).Pow(base, e);
+}
+
+// gcd(f_i, P / f_i) for every f_i, P the product of all of them, over a field and made
+// monic; product tree up, then cofactors C_v = (P / v) mod v down it via
+// C_left = C_v * right mod left, so that gcd(f_i, C_(f_i)) is the answer
+template <typename T>
+std::vector<Polynomial<T>> BatchGcd(const std::vector<Polynomial<T>>& polys) {
+    using polynomial_detail::ParallelFor;
+    static_assert(!std::numeric_limits<T>::is_integer, "BatchGcd needs a field");
+    for (const Polynomial<T>& p : polys) {
+        if (p.Degree() < 0)
+            throw std::domain_error("BatchGcd: zero polynomial");
+    }
+    if (polys.empty())
+        return {};
+    auto work = [](const std::vector<Polynomial<T>>& level) {
+        size_t total = 0;
+        for (const Polynomial<T>& p : level)
+            total += p.Degree() + 1;
+        return total;
+    };
+    std::vector<std::vector<Polynomial<T>>> tree {polys};
+    while (tree.back().size() > 1) {
+        const std::vector<Polynomial<T>>& below = tree.back();
+        std::vector<Polynomial<T>> level((below.size() + 1) / 2);
+        ParallelFor(level.size(), work(below), [&](size_t i) {
+            level[i] = 2 * i + 1 < below.size() ? below[2 * i] * below[2 * i + 1] : below[2 * i];
+        });
+        tree.push_back(std::move(level));
+    }
+    std::vector<Polynomial<T>> cofactors {Polynomial<T>(T(1))};
+    for (size_t k = tree.size() - 1; k-- > 0;) {
+        const std::vector<Polynomial<T>>& nodes = tree[k];
+        std::vector<Polynomial<T>> level(nodes.size());
+        ParallelFor(level.size(), work(nodes), [&](size_t i) {
+            if ((i ^ 1) >= nodes.size()) {
+                level[i] = cofactors[i / 2];  // unpaired node was carried up unchanged
+            } else if (nodes[i].Degree() > 0) {
+                PolynomialModulus<T> modulus(nodes[i]);
+                level[i] = modulus.MulMod(modulus.Reduce(cofactors[i / 2]), modulus.Reduce(nodes[i ^ 1]));
+            }
+        });
+        cofactors = std::move(level);
+    }
+    std::vector<Polynomial<T>> result(polys.size());
+    ParallelFor(result.size(), work(polys), [&](size_t i) {
+        result[i] = Polynomial<T> {polynomial_detail::GcdVector(polys[i].Coefficients(), cofactors[i].Coefficients())};
+    });
+    return result;
+}
+
+// true when no two of the polynomials share a nonconstant factor
+template <typename T>
+bool PairwiseCoprime(const std::vector<Polynomial<T>>& polys) {
+    for (const Polynomial<T>& g : BatchGcd(polys)) {
+        if (g.Degree() > 0)
+            return false;
+    }
+    return true;
+}
+
+// powers h^0 .. h^k mod f, shared by all compositions with the same inner polynomial
+template <typename T>
+std::vector<Polynomial<T>> CompositionPowers(const Polynomial<T>& h, const PolynomialModulus<T>& modulus, size_t k) {
+    std::vector<Polynomial<T>> powers(k + 1);
+    powers[0] = modulus.Reduce(Polynomial<T>(T(1)));
+    if (k != 0)
+        powers[1] = modulus.Reduce(h);
+    for (size_t i = 2; i <= k; ++i)
+        powers[i] = modulus.MulMod(powers[i - 1], powers[1]);
+    return powers;
+}
+
+// returns g(h) mod f by Brent-Kung from precomputed powers h^0 .. h^k, k >= 1: blocks of
+// k coefficients of g are linear combinations of the powers, joined by Horner's method in h^k
+template <typename T>
+Polynomial<T> ComposeMod(const Polynomial<T>& g, const std::vector<Polynomial<T>>& powers, const PolynomialModulus<T>& modulus) {
+    int n = g.Degree();
+    size_t k = powers.size() - 1;
+    if (n <= 0)
+        return modulus.Reduce(g);
+    size_t width = 0;
+    for (const Polynomial<T>& power : powers)
+        width = std::max(width, power.Coefficients().size());
+    Polynomial<T> result;
+    for (size_t j = (n + k) / k; j-- != 0;) {
+        std::vector<T> block(width, T());
+        for (size_t i = 0; i != k && j * k + i <= size_t(n); ++i) {
+            T c = g[j * k + i];
+            if (c == T())
+                continue;
+            const std::vector<T>& power = powers[i].Coefficients();
+            for (size_t t = 0; t != power.size(); ++t)
+                block[t] += c * power[t];
+        }
+        result = modulus.MulMod(result, powers[k]) + Polynomial<T> {std::move(block)};
+    }
+    return result;
+}
+
+// returns g(h) mod f with k ~ sqrt(deg g) baby steps
+template <typename T>
+Polynomial<T> ComposeMod(const Polynomial<T>& g, const Polynomial<T>& h, const PolynomialModulus<T>& modulus) {
+    size_t k = 1;
+    while (k * k < g.Coefficients().size())
+        ++k;
+    return ComposeMod(g, CompositionPowers(h, modulus, k), modulus);
+}
+
+// squarefree factorization over F_p (T is ModInt): pairs (g, m) with
+// f = lc(f) * prod g^m, every g monic, squarefree and pairwise coprime
+template <typename T>
+std::vector<std::pair<Polynomial<T>, int>> SquareFreeFactorization(const Polynomial<T>& f) {
+    std::vector<std::pair<Polynomial<T>, int>> result;
+    int n = f.Degree();
+    if (n <= 0)
+        return result;
+    Polynomial<T> monic = f / Polynomial<T>(f[n]);
+    Polynomial<T> derivative = monic;
+    derivative.Derivative();
+    Polynomial<T> c = monic;
+    if (derivative.Degree() >= 0) {
+        // Yun's algorithm: w collects factors of multiplicity >= i
+        c = Gcd(monic, derivative);
+        Polynomial<T> w = monic / c;
+        for (int i = 1; w.Degree() > 0; ++i) {
+            Polynomial<T> y = Gcd(w, c), z = w / y;
+            if (z.Degree() > 0)
+                result.push_back({z, i});
+            w = y;
+            c = c / y;
+        }
+    }
+    if (c.Degree() > 0) {
+        // what is left is a polynomial in x^p, its p-th root takes every p-th coefficient since a^p = a
+        uint64_t p = T::Modulus();
+        std::vector<T> root(c.Degree() / p + 1);
+        for (size_t i = 0; i != root.size(); ++i)
+            root[i] = c[i * p];
+        for (const auto& factor : SquareFreeFactorization(Polynomial<T> {std::move(root)}))
+            result.push_back({factor.first, factor.second * int(p)});
+    }
+    return result;
+}
+
+// distinct-degree factorization of squarefree monic f over F_p: pairs (g, d)
+// where g is the product of all irreducible factors of degree d; one
+// x^(p^d) mod f per degree
+template <typename T>
+std::vector<std::pair<Polynomial<T>, int>> DistinctDegreeFactorization(const Polynomial<T>& f) {
+    std::vector<std::pair<Polynomial<T>, int>> result;
+    if (f.Degree() <= 0)
+        return result;
+    const Polynomial<T> x(std::vector<T>{T(), T(1)});
+    PolynomialModulus<T> modulus(f);
+    Polynomial<T> rest = f, power = modulus.Reduce(x);
+    for (int d = 1; 2 * d <= rest.Degree(); ++d) {
+        power = PowMod(power, T::Modulus(), modulus);
+        Polynomial<T> g = Gcd(rest, power - x);
+        if (g.Degree() > 0) {
+            result.push_back({g, d});
+            rest = rest / g;
+        }
+    }
+    if (rest.Degree() > 0)
+        result.push_back({rest, rest.Degree()});
+    return result;
+}
+
+// the same factorization by Kaltofen-Shoup baby-step/giant-step: l ~ sqrt(n / 2)
+// baby steps x^(p^i) and n / 2l giant steps x^(p^(lj)) by modular composition,
+// one gcd per giant step instead of one per degree
+template <typename T>
+std::vector<std::pair<Polynomial<T>, int>> DistinctDegreeFactorizationBabyGiant(const Polynomial<T>& f) {
+    std::vector<std::pair<Polynomial<T>, int>> result;
+    int n = f.Degree();
+    if (n <= 0)
+        return result;
+    int l = std::max(1, int(std::ceil(std::sqrt(n / 2.0))));
+    int m = (n + 2 * l - 1) / (2 * l);
+    PolynomialModulus<T> modulus(f);
+    std::vector<Polynomial<T>> baby(l + 1), giant(m + 1);
+    baby[0] = modulus.Reduce(Polynomial<T>(std::vector<T>{T(), T(1)}));
+    baby[1] = PowMod(baby[0], T::Modulus(), modulus);
+    // each set of powers serves ~(l + m) / 2 compositions, so k is past sqrt(n)
+    size_t k = std::max(1, int(std::ceil(std::sqrt(n * (l + m) / 2.0))));
+    k = std::min(k, size_t(n));
+    std::vector<Polynomial<T>> powers = CompositionPowers(baby[1], modulus, k);
+    for (int i = 2; i <= l; ++i)
+        baby[i] = ComposeMod(baby[i - 1], powers, modulus);
+    giant[1] = baby[l];
+    powers = CompositionPowers(baby[l], modulus, k);
+    for (int j = 2; j <= m; ++j)
+        giant[j] = ComposeMod(giant[j - 1], powers, modulus);
+    Polynomial<T> rest = f;
+    for (int j = 1; j <= m && rest.Degree() >= 2 * l * j - 2 * l + 2; ++j) {
+        // factors of degree in (l(j - 1), lj] divide prod (x^(p^(lj)) - x^(p^i))
+        Polynomial<T> interval = modulus.Reduce(Polynomial<T>(T(1)));
+        for (int i = 0; i != l; ++i)
+            interval = modulus.MulMod(interval, giant[j] - baby[i]);
+        Polynomial<T> g = Gcd(rest, interval);
+        if (g.Degree() <= 0)
+            continue;
+        rest = rest / g;
+        if (g.Degree() <= l * j && g.Degree() < 2 * (l * (j - 1) + 1)) {
+            result.push_back({g, g.Degree()});  // room for one factor only
+            continue;
+        }
+        for (int i = l - 1; i >= 0 && g.Degree() > 0; --i) {
+            Polynomial<T> factor = Gcd(g, giant[j] - baby[i]);
+            if (factor.Degree() > 0) {
+                result.push_back({factor, l * j - i});
+                g = g / factor;
+            }
+        }
+    }
+    if (rest.Degree() > 0)
+        result.push_back({rest, rest.Degree()});
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        return a.second < b.second;
+    });
+    return result;
+}
+
+namespace polynomial_detail {
+
+// splits f (squarefree, monic, all factors of degree d) into its irreducible factors
+template <typename T>
+void EqualDegreeSplit(const Polynomial<T>& f, int d, std::mt19937_64& rng, std::vector<Polynomial<T>>& factors) {
+    int n = f.Degree();
+    if (n <= d) {
+        if (n > 0)
+            factors.push_back(f);
+        return;
+    }
+    uint64_t p = T::Modulus();
+    PolynomialModulus<T> modulus(f);
+    while (true) {
+        std::vector<T> random(n);
+        for (T& c : random)
+            c = T(rng());
+        Polynomial<T> a = Polynomial<T> {std::move(random)}, b;
+        if (a.Degree() <= 0)
+            continue;
+        if (p == 2) {
+            // trace a + a^2 + ... + a^(2^(d-1)) is 0 or 1 modulo each factor
+            Polynomial<T> power = a;
+            b = a;
+            for (int i = 1; i != d; ++i) {
+                power = modulus.SquareMod(power);
+                b += power;
+            }
+        } else {
+            // a^((p^d - 1) / 2) = (a^(1 + p + ... + p^(d-1)))^((p - 1) / 2) is +-1 modulo each factor
+            Polynomial<T> power = a, norm = a;
+            for (int i = 1; i != d; ++i) {
+                power = PowMod(power, p, modulus);
+                norm = modulus.MulMod(norm, power);
+            }
+            b = PowMod(norm, (p - 1) / 2, modulus) - Polynomial<T>(T(1));
+        }
+        Polynomial<T> g = Gcd(f, b);
+        if (g.Degree() > 0 && g.Degree() < n) {
+            EqualDegreeSplit(g, d, rng, factors);
+            EqualDegreeSplit(f / g, d, rng, factors);
+            return;
+        }
+    }
+}
+
+}  // namespace polynomial_detail
+
+// equal-degree factorization by Cantor-Zassenhaus: f squarefree monic
+// over F_p with every irreducible factor of degree d
+template <typename T>
+std::vector<Polynomial<T>> EqualDegreeFactorization(const Polynomial<T>& f, int d) {
+    std::vector<Polynomial<T>> factors;
+    std::mt19937_64 rng(f.Degree());
+    polynomial_detail::EqualDegreeSplit(f, d, rng, factors);
+    return factors;
+}
+
+// factorization over F_p into monic irreducible factors with multiplicities,
+// f = lc(f) * prod g^m; ordered by degree, then by coefficients
+template <typename T>
+std::vector<std::pair<Polynomial<T>, int>> Factorize(const Polynomial<T>& f) {
+    std::vector<std::pair<Polynomial<T>, int>> result;
+    for (const auto& squarefree : SquareFreeFactorization(f)) {
+        const Polynomial<T>& g = squarefree.first;
+        auto parts = g.Degree() >= 64 ? DistinctDegreeFactorizationBabyGiant(g) : DistinctDegreeFactorization(g);
+        for (const auto& part : parts) {
+            for (const auto& factor : EqualDegreeFactorization(part.first, part.second))
+                result.push_back({factor, squarefree.second});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) {
+        if (a.first.Degree() != b.first.Degree())
+            return a.first.Degree() < b.first.Degree();
+        return a.first.Coefficients() < b.first.Coefficients();
+    });
+    return result;
+}
+
+// all complex roots with multiplicity of a double or std::complex<double> polynomial by
+// Aberth-Ehrlich iteration started on the circles of the Newton polygon; the updates are
+// simultaneous (Jacobi style) and spread over threads from degree ROOTS_PARALLEL_DEGREE.
+// bounds, when given, receives for each root the radius of a disk around it that
+// contains a root of f (the inclusion radius n |f(z)| / |f'(z)| plus rounding)
+template <typename T>
+std::vector<std::complex<double>> ComplexRoots(const Polynomial<T>& f, std::vector<double>* bounds = nullptr) {
+    using namespace polynomial_detail;
+    if (f.Degree() < 0)
+        throw std::domain_error("ComplexRoots: zero polynomial");
+    std::vector<std::complex<double>> a(f.begin(), f.end());
+    size_t zeros = 0;
+    while (a[zeros] == 0.0)
+        ++zeros;
+    a.erase(a.begin(), a.begin() + zeros);
+    size_t n = a.size() - 1;
+    std::vector<std::complex<double>> roots, reversed(a.rbegin(), a.rend());
+    if (n > 0) {
+        std::vector<std::complex<double>> start = AberthStart(a);
+        std::vector<double> re(n), im(n);
+        for (size_t k = 0; k != n; ++k) {
+            re[k] = start[k].real();
+            im[k] = start[k].imag();
+        }
+        std::vector<char> done(n, false);
+        std::vector<std::complex<double>> next(n);
+        auto update = [&](size_t k) {
+            std::complex<double> z(re[k], im[k]);
+            next[k] = z;
+            if (done[k])
+                return;
+            double radius;
+            bool converged;
+            std::complex<double> ratio = NewtonCorrection(a, reversed, z, radius, converged);
+            if (converged) {
+                done[k] = true;
+                return;
+            }
+            double sum_re = 0, sum_im = 0;
+            InverseDistanceSum(re.data(), im.data(), 0, k, z.real(), z.imag(), sum_re, sum_im);
+            InverseDistanceSum(re.data(), im.data(), k + 1, n, z.real(), z.imag(), sum_re, sum_im);
+            std::complex<double> correction = ratio / (1.0 - ratio * std::complex<double>(sum_re, sum_im));
+            next[k] = z - correction;
+            if (std::abs(correction) <= std::numeric_limits<double>::epsilon() * std::abs(z))
+                done[k] = true;
+        };
+        for (int iteration = 0; iteration != ABERTH_MAX_ITERATIONS; ++iteration) {
+            if (n >= ROOTS_PARALLEL_DEGREE) {
+                ParallelFor(n, n * n, update);
+            } else {
+                for (size_t k = 0; k != n; ++k)
+                    update(k);
+            }
+            for (size_t k = 0; k != n; ++k) {
+                re[k] = next[k].real();
+                im[k] = next[k].imag();
+            }
+            if (std::count(done.begin(), done.end(), char(false)) == 0)
+                break;
+        }
+        roots = std::move(next);
+    }
+    if (bounds) {
+        bounds->assign(zeros, 0.0);
+        for (const std::complex<double>& z : roots) {
+            double radius;
+            bool converged;
+            NewtonCorrection(a, reversed, z, radius, converged);
+            bounds->push_back(radius);
+        }
+    }
+    roots.insert(roots.begin(), zeros, std::complex<double>());
+    return roots;
+}
+
+// linear recurrence given by characteristic polynomial
+// x^d - c[1] x^(d-1) - ... - c[d] and initial terms a[0 .. d):
+// a[n] = c[1] a[n-1] + ... + c[d] a[n-d]
+template <typename T>
+class LinearRecurrence {
+private:
+    std::vector<T> initial;        // a[0 .. d)
+    Polynomial<T> characteristic;  // monic
+    std::vector<T> denominator;    // Q(x) = x^d * characteristic(1 / x), Q(0) = 1
+    std::vector<T> numerator;      // P(x) = A(x) * Q(x) mod x^d, A / Q is the generating function
+
+    // (x^n mod characteristic) as combination of a[0 .. d)
+    T Combine(const Polynomial<T>& residue) const {
+        T result = T();
+        for (size_t i = 0; i != initial.size(); ++i)
+            result += residue[i] * initial[i];
+        return result;
+    }
+public:
+    LinearRecurrence(const Polynomial<T>& characteristic_polynomial, const std::vector<T>& initial_terms) {
+        int d = characteristic_polynomial.Degree();
+        if (d < 0)
+            throw std::invalid_argument("LinearRecurrence: zero characteristic polynomial");
+        if (initial_terms.size() < size_t(d))
+            throw std::invalid_argument("LinearRecurrence: fewer initial terms than the order");
+        T lead_inv = T(1) / characteristic_polynomial[d];
+        std::vector<T> monic(d + 1);
+        for (int i = 0; i <= d; ++i)
+            monic[i] = characteristic_polynomial[i] * lead_inv;
+        characteristic = Polynomial<T> {monic};
+        denominator.assign(monic.rbegin(), monic.rend());
+        initial.assign(initial_terms.begin(), initial_terms.begin() + d);
+        numerator = polynomial_detail::LowProduct(initial, denominator, d);
+    }
+
+    // order of the recurrence
+    int Order() const {
+        return characteristic.Degree();
+    }
+
+    // returns a[n] by Bostan-Mori: [x^n] P / Q = [x^(n / 2)] (P(x) Q(-x))_(n mod 2) / (Q(x) Q(-x))_0,
+    // both halves come from two products of size d per bit of n
+    T Term(unsigned long long n) const {
+        if (n < initial.size())
+            return initial[n];
+        std::vector<T> p = numerator, q = denominator;
+        while (n != 0 && !p.empty()) {
+            std::vector<T> q_minus = q;
+            for (size_t i = 1; i < q_minus.size(); i += 2)
+                q_minus[i] = -q_minus[i];
+            std::vector<T> u = polynomial_detail::Multiply(p, q_minus);
+            std::vector<T> v = polynomial_detail::Multiply(q, q_minus);
+            p.clear();
+            for (size_t i = n % 2; i < u.size(); i += 2)
+                p.push_back(u[i]);
+            for (size_t i = 0; i < v.size(); i += 2)
+                q[i / 2] = v[i];  // Q(x) Q(-x) is even, size of q is preserved
+            n /= 2;
+        }
+        return p.empty() ? T() : p[0] / q[0];
+    }
+
+    // returns a[n] for every index, sharing the table x^(2^k) mod characteristic
+    // between all of them (Kitamasa): each term costs popcount(n) modular products
+    std::vector<T> Terms(const std::vector<unsigned long long>& indices) const {
+        std::vector<T> result(indices.size(), T());
+        if (initial.empty())
+            return result;
+        PolynomialModulus<T> modulus(characteristic);
+        std::vector<Polynomial<T>> binary_powers{modulus.Reduce(Polynomial<T>(std::vector<T>{T(), T(1)}))};
+        for (size_t j = 0; j != indices.size(); ++j) {
+            unsigned long long n = indices[j];
+            if (n < initial.size()) {
+                result[j] = initial[n];
+                continue;
+            }
+            Polynomial<T> residue(T(1));
+            for (size_t k = 0; (n >> k) != 0; ++k) {
+                if (k == binary_powers.size())
+                    binary_powers.push_back(modulus.SquareMod(binary_powers.back()));
+                if (n >> k & 1)
+                    residue = modulus.MulMod(residue, binary_powers[k]);
+            }
+            result[j] = Combine(residue);
+        }
+        return result;
+    }
+};
+
+// minimal polynomial of a linearly recurrent sequence s by Berlekamp-Massey in O(n^2),
+// returns monic x^L + c[1] x^(L-1) + ... + c[L] with sum c[j] s[i - j] = 0 for i >= L;
+// 2L terms determine a recurrence of order L
+template <typename T>
+Polynomial<T> BerlekampMassey(const std::vector<T>& s) {
+    size_t n = s.size();
+    // c is the current connection polynomial, b the one before the last length change
+    std::vector<T> c(n + 1, T()), b(n + 1, T()), previous(n + 1, T());
+    c[0] = b[0] = T(1);
+    size_t length = 0, b_length = 0, shift = 1;
+    T last = T(1);
+    for (size_t i = 0; i != n; ++i) {
+        T discrepancy = s[i];
+        for (size_t j = 1; j <= length; ++j)
+            discrepancy += c[j] * s[i - j];
+        if (discrepancy == T()) {
+            ++shift;
+            continue;
+        }
+        T factor = discrepancy / last;
+        size_t top = std::min(n, b_length + shift);
+        if (2 * length <= i) {
+            std::copy(c.begin(), c.begin() + length + 1, previous.begin());
+            for (size_t j = shift; j <= top; ++j)
+                c[j] -= factor * b[j - shift];
+            std::fill(b.begin(), b.begin() + b_length + 1, T());
+            b.swap(previous);
+            b_length = length;
+            length = i + 1 - length;
+            last = discrepancy;
+            shift = 1;
+        } else {
+            for (size_t j = shift; j <= top; ++j)
+                c[j] -= factor * b[j - shift];
+            ++shift;
+        }
+    }
+    std::vector<T> result(length + 1);
+    for (size_t i = 0; i <= length; ++i)
+        result[length - i] = c[i];
+    return Polynomial<T> {std::move(result)};
+}
+
+// a minimal polynomial in O(M(n) log n): the first remainder of the Euclidean
+// sequence of (x^n, s(x)) below degree n / 2 is a single half-GCD, its cofactor t of
+// s is the connection polynomial scaled by t(0). The degree L always equals that of
+// BerlekampMassey and so does the polynomial when 2L <= n determines it; shorter
+// sequences may get another recurrence of order L, s = 1 gives x here and x - 1
+// from BerlekampMassey. Sequences with t(0) = 0, such as 0, 1 or 1, 0, 0, 1, have no
+// recurrence of that length with a nonzero constant term there and fall back to
+// BerlekampMassey, which finds one
+template <typename T>
+Polynomial<T> BerlekampMasseyHalfGcd(const std::vector<T>& s) {
+    size_t n = s.size();
+    std::vector<T> a(n + 1, T()), b(s);
+    a[n] = T(1);
+    polynomial_detail::Normalize(b);
+    if (b.empty())
+        return Polynomial<T>(T(1));
+    polynomial_detail::PolynomialMatrix<T> m = polynomial_detail::HalfGcd(a, b);
+    polynomial_detail::Apply(m, a, b);
+    const std::vector<T>& connection = m.a11;
+    if (connection[0] == T())
+        return BerlekampMassey(s);
+    size_t length = std::max(connection.size() - 1, b.size());
+    T scale = T(1) / connection[0];
+    std::vector<T> result(length + 1, T());
+    for (size_t i = 0; i != connection.size(); ++i)
+        result[length - i] = connection[i] * scale;
+    return Polynomial<T> {std::move(result)};
+}
+
+// binary record: this header, then the degree + 1 coefficients from lowest degree as raw T,
+// zero padded to a multiple of POLYNOMIAL_RECORD_ALIGNMENT bytes. Records may be
+// concatenated into one file and every coefficient block stays aligned
+struct PolynomialRecordHeader {
+    uint32_t magic;             // POLYNOMIAL_MAGIC
+    uint16_t version;           // POLYNOMIAL_FORMAT_VERSION of the writer
+    uint16_t type;              // type tag of the coefficients
+    uint32_t byte_order;        // POLYNOMIAL_BYTE_ORDER in the writer's byte order
+    uint32_t coefficient_size;  // sizeof(T)
+    uint64_t parameter;         // modulus for ModInt, 0 otherwise
+    int64_t degree;             // -1 for the zero polynomial
+};
+
+const uint32_t POLYNOMIAL_MAGIC = 0x594c4f50;  // "POLY" when read as little endian bytes
+const uint16_t POLYNOMIAL_FORMAT_VERSION = 1;
+const uint32_t POLYNOMIAL_BYTE_ORDER = 0x01020304;
+const size_t POLYNOMIAL_RECORD_ALIGNMENT = 32;
+
+static_assert(sizeof(PolynomialRecordHeader) % POLYNOMIAL_RECORD_ALIGNMENT == 0, "header breaks alignment");
+
+namespace polynomial_detail {
+
+// type tag and parameter of each serializable coefficient type, T is stored as raw bytes
+template <typename T, typename = void>
+struct BinaryType;
+
+template <typename T>
+struct BinaryType<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+    static constexpr uint16_t tag = (std::is_signed<T>::value ? 0x10 : 0x20) + sizeof(T);
+    static constexpr uint64_t parameter = 0;
+};
+
+template <>
+struct BinaryType<float> {
+    static constexpr uint16_t tag = 0x34;
+    static constexpr uint64_t parameter = 0;
+};
+
+template <>
+struct BinaryType<double> {
+    static constexpr uint16_t tag = 0x38;
+    static constexpr uint64_t parameter = 0;
+};
+
+template <>
+struct BinaryType<std::complex<double>> {
+    static constexpr uint16_t tag = 0x48;
+    static constexpr uint64_t parameter = 0;
+};
+
+template <uint64_t Mod>
+struct BinaryType<ModInt<Mod>> {
+    static constexpr uint16_t tag = 0x50;
+    static constexpr uint64_t parameter = Mod;
+};
+
+inline size_t PaddedSize(size_t bytes) {
+    return (bytes + POLYNOMIAL_RECORD_ALIGNMENT - 1) / POLYNOMIAL_RECORD_ALIGNMENT * POLYNOMIAL_RECORD_ALIGNMENT;
+}
+
+template <typename T>
+PolynomialRecordHeader MakeRecordHeader(int64_t degree) {
+    static_assert(std::is_trivially_copyable<T>::value, "coefficients are stored as raw bytes");
+    PolynomialRecordHeader header;
+    header.magic = POLYNOMIAL_MAGIC;
+    header.version = POLYNOMIAL_FORMAT_VERSION;
+    header.type = BinaryType<T>::tag;
+    header.byte_order = POLYNOMIAL_BYTE_ORDER;
+    header.coefficient_size = sizeof(T);
+    header.parameter = BinaryType<T>::parameter;
+    header.degree = degree;
+    return header;
+}
+
+// throws unless the header describes a record of T in native byte order with at
+// most available coefficient bytes after it
+template <typename T>
+void CheckRecordHeader(const PolynomialRecordHeader& header, uint64_t available) {
+    if (header.byte_order != POLYNOMIAL_BYTE_ORDER) {
+        if (header.byte_order == 0x04030201)
+            throw std::runtime_error("Polynomial record: written with the opposite byte order");
+        throw std::runtime_error("Polynomial record: bad header");
+    }
+    if (header.magic != POLYNOMIAL_MAGIC)
+        throw std::runtime_error("Polynomial record: bad header");
+    if (header.version > POLYNOMIAL_FORMAT_VERSION)
+        throw std::runtime_error("Polynomial record: unsupported format version");
+    if (header.type != BinaryType<T>::tag || header.coefficient_size != sizeof(T) ||
+        header.parameter != BinaryType<T>::parameter)
+        throw std::runtime_error("Polynomial record: coefficient type mismatch");
+    if (header.degree < -1 || uint64_t(header.degree + 1) > available / sizeof(T) ||
+        PaddedSize((header.degree + 1) * sizeof(T)) > available)
+        throw std::runtime_error("Polynomial record: truncated");
+}
+
+}  // namespace polynomial_detail
+
+// appends one binary record of p to out
+template <typename T>
+void WritePolynomial(std::ostream& out, const Polynomial<T>& p) {
+    PolynomialRecordHeader header = polynomial_detail::MakeRecordHeader<T>(p.Degree());
+    size_t bytes = p.Coefficients().size() * sizeof(T);
+    static const char padding[POLYNOMIAL_RECORD_ALIGNMENT] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(p.Coefficients().data()), bytes);
+    out.write(padding, polynomial_detail::PaddedSize(bytes) - bytes);
+    if (!out)
+        throw std::runtime_error("WritePolynomial: write failed");
+}
+
+// reads one binary record written by WritePolynomial into a new polynomial
+template <typename T>
+Polynomial<T> ReadPolynomial(std::istream& in) {
+    PolynomialRecordHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        throw std::runtime_error("ReadPolynomial: no record");
+    polynomial_detail::CheckRecordHeader<T>(header, std::numeric_limits<uint64_t>::max());
+    std::vector<T> coef(header.degree + 1);
+    size_t bytes = coef.size() * sizeof(T);
+    in.read(reinterpret_cast<char*>(coef.data()), bytes);
+    in.ignore(polynomial_detail::PaddedSize(bytes) - bytes);
+    if (!in)
+        throw std::runtime_error("Polynomial record: truncated");
+    return Polynomial<T> {std::move(coef)};
+}
+
+// read-only polynomial over coefficients owned elsewhere, such as a mapped file
+template <typename T>
+class PolynomialView {
+private:
+    const T* coef;
+    size_t size;
+public:
+    PolynomialView(const T* data = nullptr, size_t count = 0) : coef(data), size(count) {
+    }
+
+    int Degree() const {
+        return int(size) - 1;
+    }
+
+    T operator[] (size_t degree) const {
+        return degree < size ? coef[degree] : T();
+    }
+
+    // evaluates by Horner's method
+    T operator() (T value) const {
+        T ans = T();
+        for (size_t i = size; i-- != 0;)
+            ans = coef[i] + ans * value;
+        return ans;
+    }
+
+    const T* begin() const {
+        return coef;
+    }
+
+    const T* end() const {
+        return coef + size;
+    }
+
+    // copies the coefficients into an owning polynomial
+    Polynomial<T> ToPolynomial() const {
+        return Polynomial<T>(begin(), end());
+    }
+};
+
+// file of concatenated binary records mapped read-only into memory; the headers are
+// checked once on opening and the records are handed out as zero-copy views, which
+// stay valid as long as the file object lives
+template <typename T>
+class MappedPolynomialFile {
+private:
+    void* base = nullptr;
+    size_t length = 0;
+    std::vector<PolynomialView<T>> records;
+
+    void Unmap() {
+        if (length != 0)
+            munmap(base, length);
+        base = nullptr;
+        length = 0;
+        records.clear();
+    }
+public:
+    explicit MappedPolynomialFile(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("MappedPolynomialFile: cannot open " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw std::runtime_error("MappedPolynomialFile: cannot stat " + path);
+        }
+        if (info.st_size != 0) {
+            base = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (base == MAP_FAILED) {
+                close(fd);
+                throw std::runtime_error("MappedPolynomialFile: cannot map " + path);
+            }
+            length = info.st_size;
+        }
+        close(fd);
+        const char* data = static_cast<const char*>(base);
+        try {
+            for (size_t offset = 0; offset != length;) {
+                PolynomialRecordHeader header;
+                if (length - offset < sizeof(header))
+                    throw std::runtime_error("Polynomial record: truncated");
+                std::memcpy(&header, data + offset, sizeof(header));
+                offset += sizeof(header);
+                polynomial_detail::CheckRecordHeader<T>(header, length - offset);
+                records.emplace_back(reinterpret_cast<const T*>(data + offset), header.degree + 1);
+                offset += polynomial_detail::PaddedSize((header.degree + 1) * sizeof(T));
+            }
+        } catch (...) {
+            Unmap();
+            throw;
+        }
+    }
+
+    MappedPolynomialFile(const MappedPolynomialFile&) = delete;
+    MappedPolynomialFile& operator = (const MappedPolynomialFile&) = delete;
+
+    MappedPolynomialFile(MappedPolynomialFile&& other) noexcept
+        : base(other.base), length(other.length), records(std::move(other.records)) {
+        other.base = nullptr;
+        other.length = 0;
+    }
+
+    MappedPolynomialFile& operator = (MappedPolynomialFile&& other) noexcept {
+        if (this != &other) {
+            Unmap();
+            std::swap(base, other.base);
+            std::swap(length, other.length);
+            records.swap(other.records);
+        }
+        return *this;
+    }
+
+    ~MappedPolynomialFile() {
+        Unmap();
+    }
+
+    size_t Size() const {
+        return records.size();
+    }
+
+    const PolynomialView<T>& operator[] (size_t i) const {
+        return records[i];
+    }
+
+    typename std::vector<PolynomialView<T>>::const_iterator begin() const {
+        return records.begin();
+    }
+
+    typename std::vector<PolynomialView<T>>::const_iterator end() const {
+        return records.end();
+    }
+};
+
+namespace polynomial_detail {
+
+// owns a POSIX file descriptor
+class FileDescriptor {
+private:
+    int fd;
+public:
+    FileDescriptor(const std::string& path, int flags) : fd(open(path.c_str(), flags, 0644)) {
+        if (fd < 0)
+            throw std::runtime_error("cannot open " + path);
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator = (const FileDescriptor&) = delete;
+
+    ~FileDescriptor() {
+        close(fd);
+    }
+
+    int Get() const {
+        return fd;
+    }
+};
+
+inline void ReadFully(int fd, void* data, size_t bytes, uint64_t offset) {
+    for (char* p = static_cast<char*>(data); bytes != 0;) {
+        ssize_t done = pread(fd, p, bytes, offset);
+        if (done <= 0)
+            throw std::runtime_error("Polynomial file: read failed");
+        p += done;
+        bytes -= done;
+        offset += done;
+    }
+}
+
+inline void WriteFully(int fd, const void* data, size_t bytes, uint64_t offset) {
+    for (const char* p = static_cast<const char*>(data); bytes != 0;) {
+        ssize_t done = pwrite(fd, p, bytes, offset);
+        if (done <= 0)
+            throw std::runtime_error("Polynomial file: write failed");
+        p += done;
+        bytes -= done;
+        offset += done;
+    }
+}
+
+// O_TRUNC on the result would wipe an operand before it is read, so the same file under
+// another name (hard link, symlink, relative path) is caught by device and inode
+inline void CheckResultFile(const std::string& result, const std::string& operand) {
+    struct stat r, o;
+    if (stat(result.c_str(), &r) != 0 || stat(operand.c_str(), &o) != 0)
+        return;
+    if (r.st_dev == o.st_dev && r.st_ino == o.st_ino)
+        throw std::invalid_argument("Polynomial file: result " + result + " is the operand " + operand);
+}
+
+// yields coefficient ranges [start, start + count) to read next, false at the end
+using ChunkSequence = std::function<bool(uint64_t& start, size_t& count)>;
+
+// reads the coefficient ranges of a record file in the order the sequence gives them; the
+// next range is already being read on a std::async task while the caller works on this one
+template <typename T>
+class ChunkReader {
+private:
+    int fd;
+    ChunkSequence next;
+    std::future<std::vector<T>> pending;
+
+    void Prefetch() {
+        uint64_t start;
+        size_t count;
+        if (!next(start, count))
+            return;
+        pending = std::async(std::launch::async, [fd = fd, start, count]() {
+            std::vector<T> chunk(count);
+            ReadFully(fd, chunk.data(), count * sizeof(T), sizeof(PolynomialRecordHeader) + start * sizeof(T));
+            return chunk;
+        });
+    }
+public:
+    ChunkReader(int file, ChunkSequence sequence) : fd(file), next(std::move(sequence)) {
+        Prefetch();
+    }
+
+    bool Read(std::vector<T>& chunk) {
+        if (!pending.valid())
+            return false;
+        chunk = pending.get();
+        Prefetch();
+        return true;
+    }
+};
+
+// writes consecutive coefficient chunks of a new record file; each chunk goes out on a
+// std::async task while the caller computes the next one. Finish drops top zeros and
+// writes the header
+template <typename T>
+class ChunkWriter {
+private:
+    FileDescriptor file;
+    uint64_t written = 0, significant = 0;
+    std::vector<T> buffer;
+    std::future<void> pending;
+public:
+    explicit ChunkWriter(const std::string& path) : file(path, O_WRONLY | O_CREAT | O_TRUNC) {
+    }
+
+    ~ChunkWriter() {
+        if (pending.valid())
+            pending.wait();
+    }
+
+    void Write(std::vector<T>&& chunk) {
+        for (size_t i = chunk.size(); i-- != 0;) {
+            if (chunk[i] != T()) {
+                significant = written + i + 1;
+                break;
+            }
+        }
+        if (pending.valid())
+            pending.get();
+        buffer = std::move(chunk);
+        uint64_t offset = sizeof(PolynomialRecordHeader) + written * sizeof(T);
+        written += buffer.size();
+        pending = std::async(std::launch::async, [this, offset]() {
+            WriteFully(file.Get(), buffer.data(), buffer.size() * sizeof(T), offset);
+        });
+    }
+
+    void Finish() {
+        if (pending.valid())
+            pending.get();
+        PolynomialRecordHeader header = MakeRecordHeader<T>(int64_t(significant) - 1);
+        WriteFully(file.Get(), &header, sizeof(header), 0);
+        // cuts the top zeros or pads with zeros up to the alignment
+        if (ftruncate(file.Get(), sizeof(header) + PaddedSize(significant * sizeof(T))) != 0)
+            throw std::runtime_error("Polynomial file: write failed");
+    }
+};
+
+}  // namespace polynomial_detail
+
+// polynomial stored in a file as a single binary record (see WritePolynomial) and
+// processed in chunks of coefficients, for sizes beyond memory. Reads run one chunk
+// ahead and writes one chunk behind the computation. Results of arithmetic go to new
+// files; a result naming an operand file throws std::invalid_argument
+template <typename T>
+class FilePolynomial {
+private:
+    std::string path;
+    uint64_t size = 0;  // coefficients
+    size_t chunk;
+
+    // chunks of length step over the coefficients, from the lowest or from the top
+    polynomial_detail::ChunkSequence Chunks(size_t step, bool descending) const {
+        uint64_t blocks = (size + step - 1) / step, index = 0, total = size;
+        return [=](uint64_t& start, size_t& count) mutable {
+            if (index == blocks)
+                return false;
+            uint64_t block = descending ? blocks - 1 - index : index;
+            ++index;
+            start = block * step;
+            count = std::min<uint64_t>(step, total - start);
+            return true;
+        };
+    }
+
+    // block by block combination of two files, op(x, y) updates x
+    template <typename Op>
+    FilePolynomial Combine(const FilePolynomial& other, const std::string& result_path, Op op) const {
+        polynomial_detail::CheckResultFile(result_path, path);
+        polynomial_detail::CheckResultFile(result_path, other.path);
+        polynomial_detail::FileDescriptor a(path, O_RDONLY), b(other.path, O_RDONLY);
+        polynomial_detail::ChunkReader<T> left(a.Get(), Chunks(chunk, false)), right(b.Get(), other.Chunks(chunk, false));
+        polynomial_detail::ChunkWriter<T> out(result_path);
+        std::vector<T> x, y;
+        while (true) {
+            bool has_x = left.Read(x), has_y = right.Read(y);
+            if (!has_x && !has_y)
+                break;
+            if (!has_x)
+                x.clear();
+            if (!has_y)
+                y.clear();
+            x.resize(std::max(x.size(), y.size()), T());
+            op(x, y);
+            out.Write(std::move(x));
+            x.clear();
+        }
+        out.Finish();
+        return FilePolynomial(result_path, chunk);
+    }
+public:
+    // opens a file holding one record written by WritePolynomial or a FilePolynomial
+    explicit FilePolynomial(const std::string& file_path, size_t chunk_size = polynomial_detail::OUT_OF_CORE_CHUNK)
+        : path(file_path), chunk(std::max<size_t>(chunk_size, 1)) {
+        polynomial_detail::FileDescriptor file(path, O_RDONLY);
+        struct stat info;
+        PolynomialRecordHeader header;
+        if (fstat(file.Get(), &info) != 0 || uint64_t(info.st_size) < sizeof(header))
+            throw std::runtime_error("Polynomial record: truncated");
+        polynomial_detail::ReadFully(file.Get(), &header, sizeof(header), 0);
+        polynomial_detail::CheckRecordHeader<T>(header, info.st_size - sizeof(header));
+        size = header.degree + 1;
+    }
+
+    // writes p to a new file
+    static FilePolynomial Create(const std::string& file_path, const Polynomial<T>& p,
+                                 size_t chunk_size = polynomial_detail::OUT_OF_CORE_CHUNK) {
+        std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
+        WritePolynomial(out, p);
+        out.close();
+        return FilePolynomial(file_path, chunk_size);
+    }
+
+    int64_t Degree() const {
+        return int64_t(size) - 1;
+    }
+
+    const std::string& Path() const {
+        return path;
+    }
+
+    // reads the whole polynomial into memory
+    Polynomial<T> Load() const {
+        std::ifstream in(path, std::ios::binary);
+        return ReadPolynomial<T>(in);
+    }
+
+    // Horner's method running over the chunks from the top degree down
+    T operator() (T value) const {
+        polynomial_detail::FileDescriptor file(path, O_RDONLY);
+        polynomial_detail::ChunkReader<T> reader(file.Get(), Chunks(chunk, true));
+        T ans = T();
+        std::vector<T> block;
+        while (reader.Read(block)) {
+            for (size_t i = block.size(); i-- != 0;)
+                ans = block[i] + ans * value;
+        }
+        return ans;
+    }
+
+    FilePolynomial Add(const FilePolynomial& other, const std::string& result_path) const {
+        return Combine(other, result_path, [](std::vector<T>& x, const std::vector<T>& y) {
+            for (size_t i = 0; i != y.size(); ++i)
+                x[i] += y[i];
+        });
+    }
+
+    FilePolynomial Subtract(const FilePolynomial& other, const std::string& result_path) const {
+        return Combine(other, result_path, [](std::vector<T>& x, const std::vector<T>& y) {
+            for (size_t i = 0; i != y.size(); ++i)
+                x[i] -= y[i];
+        });
+    }
+
+    FilePolynomial Scale(const T& c, const std::string& result_path) const {
+        polynomial_detail::CheckResultFile(result_path, path);
+        polynomial_detail::FileDescriptor file(path, O_RDONLY);
+        polynomial_detail::ChunkReader<T> reader(file.Get(), Chunks(chunk, false));
+        polynomial_detail::ChunkWriter<T> out(result_path);
+        std::vector<T> block;
+        while (reader.Read(block)) {
+            for (T& x : block)
+                x *= c;
+            out.Write(std::move(block));
+            block.clear();
+        }
+        out.Finish();
+        return FilePolynomial(result_path, chunk);
+    }
+
+    // overlap-add over blocks of chunk coefficients: output block k collects the products
+    // a_i * b_(k - i) of in-memory blocks, each spilling its upper half into block k + 1
+    FilePolynomial Multiply(const FilePolynomial& other, const std::string& result_path) const {
+        polynomial_detail::CheckResultFile(result_path, path);
+        polynomial_detail::CheckResultFile(result_path, other.path);
+        polynomial_detail::ChunkWriter<T> out(result_path);
+        if (size != 0 && other.size != 0) {
+            uint64_t step = chunk, na = (size + step - 1) / step, nb = (other.size + step - 1) / step;
+            uint64_t total = size + other.size - 1, blocks = (total + step - 1) / step;
+            // both operands are read in the order (i, k - i) of the sums below
+            uint64_t sizes[2] = {size, other.size};
+            auto pairs = [step, na, nb, sizes](bool left) -> polynomial_detail::ChunkSequence {
+                uint64_t k = 0, i = 0;
+                bool started = false;
+                return [=](uint64_t& start, size_t& count) mutable {
+                    while (!started || i > std::min(k, na - 1)) {
+                        if (started)
+                            ++k;
+                        if (k > na + nb - 2)
+                            return false;
+                        i = k >= nb ? k - nb + 1 : 0;
+                        started = true;
+                    }
+                    start = (left ? i : k - i) * step;
+                    count = std::min<uint64_t>(step, sizes[left ? 0 : 1] - start);
+                    ++i;
+                    return true;
+                };
+            };
+            polynomial_detail::FileDescriptor a(path, O_RDONLY), b(other.path, O_RDONLY);
+            polynomial_detail::ChunkReader<T> left(a.Get(), pairs(true)), right(b.Get(), pairs(false));
+            std::vector<T> carry, x, y;
+            for (uint64_t k = 0; k != blocks; ++k) {
+                std::vector<T> acc(2 * step, T());
+                std::copy(carry.begin(), carry.end(), acc.begin());
+                uint64_t first = k >= nb ? k - nb + 1 : 0, last = std::min(k, na - 1);
+                for (uint64_t i = first; i <= last && k <= na + nb - 2; ++i) {
+                    left.Read(x);
+                    right.Read(y);
+                    std::vector<T> product = polynomial_detail::Multiply(x, y);
+                    for (size_t j = 0; j != product.size(); ++j)
+                        acc[j] += product[j];
+                }
+                carry.assign(acc.begin() + step, acc.end());
+                acc.resize(std::min<uint64_t>(step, total - k * step));
+                out.Write(std::move(acc));
+            }
+        }
+        out.Finish();
+        return FilePolynomial(result_path, chunk);
+    }
+};
+
+namespace polynomial_detail {
+
+// zigzag mapping of signed values to unsigned ones: 0, -1, 1, -2, ... become 0, 1, 2, 3, ...
+template <typename T>
+uint64_t ZigZag(T x) {
+    int64_t v = int64_t(x);
+    return (uint64_t(v) << 1) ^ uint64_t(v >> 63);
+}
+
+// packs count values of width bits each from the lowest bit of words on; words must be
+// zeroed and hold count * width bits
+inline void PackBlock(const uint64_t* values, size_t count, unsigned width, uint64_t* words) {
+    if (width == 0)
+        return;
+    for (size_t i = 0; i != count; ++i) {
+        size_t bit = i * width, word = bit >> 6;
+        unsigned shift = bit & 63;
+        words[word] |= values[i] << shift;
+        if (shift + width > 64)
+            words[word + 1] |= values[i] >> (64 - shift);
+    }
+}
+
+// reads the value at bit of words, one word past it has to be readable
+inline uint64_t UnpackValue(const uint64_t* words, size_t bit, uint64_t mask) {
+    unsigned shift = bit & 63;
+    words += bit >> 6;
+    // (hi << 1) << (63 - shift) is hi << (64 - shift) without shifting by 64
+    return ((words[0] >> shift) | ((words[1] << 1) << (63 - shift))) & mask;
+}
+
+// inverse of PackBlock followed by the zigzag decoding. The loop has no branches and
+// vectorizes
+template <typename T>
+void UnpackBlock(const uint64_t* words, size_t count, unsigned width, T* data) {
+    if (width == 0) {
+        std::fill(data, data + count, T());
+        return;
+    }
+    uint64_t mask = ~uint64_t(0) >> (64 - width);
+    for (size_t i = 0; i != count; ++i) {
+        uint64_t z = UnpackValue(words, i * width, mask);
+        data[i] = T((z >> 1) ^ (0 - (z & 1)));
+    }
+}
+
+}  // namespace polynomial_detail
+
+// integer polynomial stored in blocks of COMPRESSION_BLOCK zigzag coded coefficients, packed
+// with the bit width that fits most of the block; the few coefficients that do not fit
+// are kept aside as exceptions with their position. Mostly small coefficients with rare
+// large ones cost a few bits each, and evaluation and addition decode one block at a
+// time without inflating the whole polynomial
+template <typename T>
+class CompressedPolynomial {
+    static_assert(std::is_integral<T>::value && sizeof(T) <= sizeof(uint64_t),
+                  "CompressedPolynomial packs integer coefficients of at most 64 bits");
+    static_assert(polynomial_detail::COMPRESSION_BLOCK <= 256, "exception positions are stored in bytes");
+private:
+    using Block = std::array<T, polynomial_detail::COMPRESSION_BLOCK>;
+
+    size_t size = 0;  // coefficients
+    std::vector<uint8_t> widths;
+    std::vector<size_t> offsets;  // first word of each block
+    std::vector<uint64_t> words {0};  // one spare word for UnpackValue
+    std::vector<size_t> exception_offsets {0};  // first exception of each block, and the end
+    std::vector<uint8_t> exception_positions;
+    std::vector<T> exception_values;
+
+    size_t Blocks() const {
+        return widths.size();
+    }
+
+    size_t BlockSize(size_t block) const {
+        return std::min(polynomial_detail::COMPRESSION_BLOCK, size - block * polynomial_detail::COMPRESSION_BLOCK);
+    }
+
+    // decodes the block into data, zeros past the end of the polynomial
+    void Decode(size_t block, T* data) const {
+        size_t count = block < Blocks() ? BlockSize(block) : 0;
+        if (count != 0) {
+            polynomial_detail::UnpackBlock(words.data() + offsets[block], count, widths[block], data);
+            for (size_t i = exception_offsets[block]; i != exception_offsets[block + 1]; ++i)
+                data[exception_positions[i]] = exception_values[i];
+        }
+        std::fill(data + count, data + polynomial_detail::COMPRESSION_BLOCK, T());
+    }
+
+    void Append(const T* data, size_t count) {
+        std::array<uint64_t, polynomial_detail::COMPRESSION_BLOCK> values;
+        size_t lengths[65] = {};
+        for (size_t i = 0; i != count; ++i) {
+            values[i] = polynomial_detail::ZigZag(data[i]);
+            ++lengths[values[i] == 0 ? 0 : 64 - __builtin_clzll(values[i])];
+        }
+        // an exception costs its value and a position byte instead of width bits
+        const size_t exception_bits = 8 * (sizeof(T) + 1);
+        unsigned width = 64;
+        size_t above = 0, best = count * 64;
+        for (unsigned w = 64; w-- != 0;) {
+            above += lengths[w + 1];
+            if (count * w + above * exception_bits < best) {
+                best = count * w + above * exception_bits;
+                width = w;
+            }
+        }
+        for (size_t i = 0; i != count; ++i) {
+            if (width < 64 && values[i] >> width != 0) {
+                exception_positions.push_back(i);
+                exception_values.push_back(data[i]);
+                values[i] = 0;
+            }
+        }
+        size_t offset = words.size() - 1;
+        words.resize(offset + (count * width + 63) / 64 + 1, 0);
+        polynomial_detail::PackBlock(values.data(), count, width, words.data() + offset);
+        widths.push_back(width);
+        offsets.push_back(offset);
+        exception_offsets.push_back(exception_values.size());
+        size += count;
+    }
+
+    void PopBlock() {
+        size -= BlockSize(Blocks() - 1);
+        words.resize(offsets.back() + 1);
+        words.back() = 0;
+        widths.pop_back();
+        offsets.pop_back();
+        exception_offsets.pop_back();
+        exception_positions.resize(exception_offsets.back());
+        exception_values.resize(exception_offsets.back());
+    }
+
+    // keeps the first significant coefficients, the rest are zeros of a sum
+    void Truncate(size_t significant) {
+        while (Blocks() != 0 && significant <= (Blocks() - 1) * polynomial_detail::COMPRESSION_BLOCK)
+            PopBlock();
+        if (significant < size) {
+            Block data;
+            Decode(Blocks() - 1, data.data());
+            PopBlock();
+            Append(data.data(), significant - size);
+        }
+    }
+
+    // sign = 1 for the sum and -1 for the difference
+    CompressedPolynomial Combine(const CompressedPolynomial& other, T sign) const {
+        CompressedPolynomial result;
+        size_t total = std::max(size, other.size), significant = 0;
+        Block x, y;
+        for (size_t block = 0; block * polynomial_detail::COMPRESSION_BLOCK < total; ++block) {
+            Decode(block, x.data());
+            other.Decode(block, y.data());
+            size_t first = block * polynomial_detail::COMPRESSION_BLOCK;
+            size_t count = std::min(polynomial_detail::COMPRESSION_BLOCK, total - first);
+            for (size_t i = 0; i != count; ++i) {
+                x[i] += sign * y[i];
+                if (x[i] != T())
+                    significant = first + i + 1;
+            }
+            result.Append(x.data(), count);
+        }
+        result.Truncate(significant);
+        return result;
+    }
+public:
+    CompressedPolynomial() = default;
+
+    explicit CompressedPolynomial(const Polynomial<T>& p) {
+        const std::vector<T>& coef = p.Coefficients();
+        size_t blocks = (coef.size() + polynomial_detail::COMPRESSION_BLOCK - 1) / polynomial_detail::COMPRESSION_BLOCK;
+        widths.reserve(blocks);
+        offsets.reserve(blocks);
+        exception_offsets.reserve(blocks + 1);
+        for (size_t first = 0; first < coef.size(); first += polynomial_detail::COMPRESSION_BLOCK)
+            Append(coef.data() + first, std::min(polynomial_detail::COMPRESSION_BLOCK, coef.size() - first));
+        words.shrink_to_fit();
+        exception_positions.shrink_to_fit();
+        exception_values.shrink_to_fit();
+    }
+
+    int Degree() const {
+        return int(size) - 1;
+    }
+
+    // bytes held by the packed representation
+    size_t Bytes() const {
+        return words.size() * sizeof(uint64_t) + Blocks() * (sizeof(uint8_t) + 2 * sizeof(size_t)) +
+               exception_values.size() * (sizeof(T) + sizeof(uint8_t));
+    }
+
+    T operator[] (size_t degree) const {
+        if (degree >= size)
+            return T();
+        size_t block = degree / polynomial_detail::COMPRESSION_BLOCK, position = degree % polynomial_detail::COMPRESSION_BLOCK;
+        auto first = exception_positions.begin() + exception_offsets[block];
+        auto last = exception_positions.begin() + exception_offsets[block + 1];
+        auto it = std::lower_bound(first, last, position);
+        if (it != last && *it == position)
+            return exception_values[it - exception_positions.begin()];
+        unsigned width = widths[block];
+        if (width == 0)
+            return T();
+        uint64_t z = polynomial_detail::UnpackValue(words.data() + offsets[block], position * width, ~uint64_t(0) >> (64 - width));
+        return T((z >> 1) ^ (0 - (z & 1)));
+    }
+
+    // Horner's method over the blocks from the top degree down
+    T operator() (T value) const {
+        T ans = T();
+        Block data;
+        for (size_t block = Blocks(); block-- != 0;) {
+            Decode(block, data.data());
+            for (size_t i = BlockSize(block); i-- != 0;)
+                ans = data[i] + ans * value;
+        }
+        return ans;
+    }
+
+    CompressedPolynomial operator + (const CompressedPolynomial& other) const {
+        return Combine(other, T(1));
+    }
+
+    CompressedPolynomial operator - (const CompressedPolynomial& other) const {
+        return Combine(other, T(-1));
+    }
+
+    bool operator == (const CompressedPolynomial& other) const {
+        if (size != other.size)
+            return false;
+        Block x, y;
+        for (size_t block = 0; block != Blocks(); ++block) {
+            Decode(block, x.data());
+            other.Decode(block, y.data());
+            if (x != y)
+                return false;
+        }
+        return true;
+    }
+
+    bool operator != (const CompressedPolynomial& other) const {
+        return !(*this == other);
+    }
+
+    // inflates back into a dense polynomial
+    Polynomial<T> Decompress() const {
+        std::vector<T> coef(Blocks() * polynomial_detail::COMPRESSION_BLOCK);
+        for (size_t block = 0; block != Blocks(); ++block)
+            Decode(block, coef.data() + block * polynomial_detail::COMPRESSION_BLOCK);
+        coef.resize(size);
+        return Polynomial<T> {std::move(coef)};
+    }
+};
+
+// polynomial kept as its nonzero terms sorted by exponent, for polynomials with few terms
+// and possibly huge degree such as x^1000000 + 1. Products merge the partial products
+// through a heap of size min(terms) as in Johnson's algorithm
 template <typename T>
-class Polynomial {
+class SparsePolynomial {
+public:
+    using Term = std::pair<uint64_t, T>;  // exponent and coefficient
 private:
-    std::vector<T> coef;
+    std::vector<Term> terms;
 
-    // delete leading non-significant zeros
-    void Delete_Front_Zeros() {
-        while (!coef.empty() && coef.back() == T())
-            coef.pop_back();
+    // merges two term lists, other scaled by sign
+    SparsePolynomial Combine(const SparsePolynomial& other, T sign) const {
+        SparsePolynomial result;
+        result.terms.reserve(terms.size() + other.terms.size());
+        size_t i = 0, j = 0;
+        while (i != terms.size() || j != other.terms.size()) {
+            if (j == other.terms.size() || (i != terms.size() && terms[i].first < other.terms[j].first)) {
+                result.terms.push_back(terms[i++]);
+            } else if (i == terms.size() || other.terms[j].first < terms[i].first) {
+                result.terms.emplace_back(other.terms[j].first, sign * other.terms[j].second);
+                ++j;
+            } else {
+                T c = terms[i].second + sign * other.terms[j].second;
+                if (c != T())
+                    result.terms.emplace_back(terms[i].first, c);
+                ++i;
+                ++j;
+            }
+        }
+        return result;
     }
 public:
-    // initialize polynomial with vector of coefficients
-    Polynomial(const std::vector<T>& v) : coef(v) {
-        Delete_Front_Zeros();
-    }
+    SparsePolynomial() = default;
 
-    // initialize constant polynomial
-    Polynomial(T c = T()) {
-        if (c != T())
-            coef.push_back(c);
+    // terms in any order, equal exponents are summed and zero terms dropped
+    explicit SparsePolynomial(std::vector<Term> v) : terms(std::move(v)) {
+        std::stable_sort(terms.begin(), terms.end(), [](const Term& a, const Term& b) {
+            return a.first < b.first;
+        });
+        size_t k = 0;
+        for (size_t i = 0; i != terms.size();) {
+            Term t = terms[i++];
+            for (; i != terms.size() && terms[i].first == t.first; ++i)
+                t.second += terms[i].second;
+            if (t.second != T())
+                terms[k++] = t;
+        }
+        terms.resize(k);
     }
 
-    // initialize polynomial with the pair of iterators
-    template <typename Iter>
-    Polynomial(Iter first, Iter last) {
-        while (first != last) {
-            coef.push_back(*first++);
+    explicit SparsePolynomial(const Polynomial<T>& p) {
+        const std::vector<T>& coef = p.Coefficients();
+        for (size_t i = 0; i != coef.size(); ++i) {
+            if (coef[i] != T())
+                terms.emplace_back(i, coef[i]);
         }
-        Delete_Front_Zeros();
     }
-    
+
     // returns degree of polynomial or -1 if it is zero polynomial
-    int Degree() const {
-        for (int i = coef.size() - 1; i >= 0; --i) {
-            if (coef[i] != T())
-                return i;
+    int64_t Degree() const {
+        return terms.empty() ? -1 : int64_t(terms.back().first);
+    }
+
+    // number of nonzero terms
+    size_t Size() const {
+        return terms.size();
+    }
+
+    const std::vector<Term>& Terms() const {
+        return terms;
+    }
+
+    T operator[] (uint64_t degree) const {
+        auto it = std::lower_bound(terms.begin(), terms.end(), degree, [](const Term& t, uint64_t e) {
+            return t.first < e;
+        });
+        return it != terms.end() && it->first == degree ? it->second : T();
+    }
+
+    // Horner's method over the gaps between exponents
+    T operator() (T value) const {
+        T ans = T();
+        for (size_t i = terms.size(); i-- != 0;) {
+            ans += terms[i].second;
+            ans = ans * polynomial_detail::PowScalar(value, terms[i].first - (i != 0 ? terms[i - 1].first : 0));
         }
-        return -1;
+        return ans;
     }
 
-    // returns coefficient before this degree
-    T operator[] (size_t degree) const {
-        if (coef.size() > degree)
-            return coef[degree];
-        else
-            return T();  // returns default value if requested degree is higher than max degree
+    bool operator == (const SparsePolynomial& other) const {
+        return terms == other.terms;
     }
 
-    // returns true if two polynomials are equal, false otherwise
-    bool operator == (const Polynomial<T>& other) const {
-        int fd = Degree();
-        int sd = other.Degree();
-        if (fd != sd) {
-            return false;
-        } else {
-            for (; fd >= 0; --fd) {
-                if ((*this)[fd] != other[fd]) {
-                    return false;
+    bool operator != (const SparsePolynomial& other) const {
+        return !(*this == other);
+    }
+
+    SparsePolynomial operator + (const SparsePolynomial& other) const {
+        return Combine(other, T(1));
+    }
+
+    SparsePolynomial operator - (const SparsePolynomial& other) const {
+        return Combine(other, T(-1));
+    }
+
+    SparsePolynomial operator * (const SparsePolynomial& other) const {
+        const std::vector<Term>& a = terms.size() <= other.terms.size() ? terms : other.terms;
+        const std::vector<Term>& b = terms.size() <= other.terms.size() ? other.terms : terms;
+        SparsePolynomial result;
+        if (a.empty())
+            return result;
+        // entry (exponent, i): a[i] times the next unused term of b, next[i] is its index
+        using Entry = std::pair<uint64_t, size_t>;
+        std::vector<Entry> heap;
+        std::vector<size_t> next(a.size(), 0);
+        heap.reserve(a.size());
+        for (size_t i = 0; i != a.size(); ++i)
+            heap.emplace_back(a[i].first + b[0].first, i);
+        auto later = [](const Entry& x, const Entry& y) {
+            return x.first > y.first;
+        };
+        std::make_heap(heap.begin(), heap.end(), later);
+        while (!heap.empty()) {
+            uint64_t exponent = heap.front().first;
+            T c = T();
+            while (!heap.empty() && heap.front().first == exponent) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                size_t i = heap.back().second;
+                c += a[i].second * b[next[i]].second;
+                if (++next[i] != b.size()) {
+                    heap.back().first = a[i].first + b[next[i]].first;
+                    std::push_heap(heap.begin(), heap.end(), later);
+                } else {
+                    heap.pop_back();
                 }
             }
-            return true;
+            if (c != T())
+                result.terms.emplace_back(exponent, c);
         }
+        return result;
     }
 
-    // returns true if two polynomials are not equal, false otherwise
-    bool operator != (const Polynomial<T>& other) const {
-        return !(*this == other);
+    Polynomial<T> ToDense() const {
+        std::vector<T> coef(Degree() + 1, T());
+        for (const Term& t : terms)
+            coef[t.first] = t.second;
+        return Polynomial<T> {std::move(coef)};
     }
+};
 
-    // sum of two polynomials
-    Polynomial<T> operator + (const Polynomial<T>& other) const {
-        size_t pol_size = std::max(coef.size(), other.coef.size());
-        std::vector<T> pol(pol_size, T());  // resizing with default values
-        for (size_t i = 0; i != pol_size; ++i)
-            pol[i] = (*this)[i] + other[i];
-        return Polynomial<T> {pol};
+// polynomial that keeps the dense or the sparse form, whichever suits its fill ratio,
+// and builds the other form on first request. Arithmetic runs on the form both operands
+// prefer; a product goes through the heap unless its term pairs outnumber the
+// coefficients of the dense product
+template <typename T>
+class HybridPolynomial {
+private:
+    mutable Polynomial<T> dense;
+    mutable SparsePolynomial<T> sparse;
+    mutable bool has_dense = false, has_sparse = false;
+    size_t size = 0;  // nonzero terms
+    int64_t degree = -1;
+
+    explicit HybridPolynomial(Polynomial<T>&& p, size_t count) : dense(std::move(p)), has_dense(true), size(count),
+                                                                 degree(dense.Degree()) {
     }
 
-    // difference of two polynomials
-    Polynomial<T> operator - (const Polynomial<T>& other) const {  
-        size_t pol_size = std::max(coef.size(), other.coef.size());
-        std::vector<T> pol(pol_size, T());
-        for (size_t i = 0; i != pol_size; ++i)
-            pol[i] = (*this)[i] - other[i];
-        return Polynomial<T> {pol};
+    static HybridPolynomial FromDense(Polynomial<T>&& p) {
+        size_t count = std::count_if(p.begin(), p.end(), [](const T& c) {
+            return c != T();
+        });
+        return HybridPolynomial(std::move(p), count);
+    }
+public:
+    HybridPolynomial() : has_sparse(true) {
     }
 
-    // product of two polynomials
-    Polynomial<T> operator * (const Polynomial<T>& other) const {  
-        size_t pol_size = coef.size() + other.coef.size();
-        std::vector<T> pol(pol_size, T());
-        for (size_t i = 0; i != coef.size(); ++i) {
-            for (size_t j = 0; j != other.coef.size(); ++j)
-                pol[i + j] += (*this)[i] * other[j];
+    HybridPolynomial(const Polynomial<T>& p) : HybridPolynomial(FromDense(Polynomial<T>(p))) {
+    }
+
+    HybridPolynomial(const SparsePolynomial<T>& p) : sparse(p), has_sparse(true), size(p.Size()), degree(p.Degree()) {
+    }
+
+    int64_t Degree() const {
+        return degree;
+    }
+
+    // number of nonzero terms
+    size_t Size() const {
+        return size;
+    }
+
+    // true when at most 1 / SPARSE_FILL_DIVISOR of the coefficients up to the degree are nonzero
+    bool IsSparse() const {
+        return size <= uint64_t(degree + 1) / polynomial_detail::SPARSE_FILL_DIVISOR;
+    }
+
+    const Polynomial<T>& Dense() const {
+        if (!has_dense) {
+            dense = sparse.ToDense();
+            has_dense = true;
         }
-        return Polynomial<T> {pol};
+        return dense;
     }
 
-    // sum of two polynomials
-    Polynomial<T>& operator += (const Polynomial<T>& other) {
-        size_t pol_size = std::max(coef.size(), other.coef.size());
-        coef.resize(pol_size, T());
-        for (size_t i = 0; i != pol_size; ++i)
-            coef[i] += other[i];
-        Delete_Front_Zeros();
-        return *this;
+    const SparsePolynomial<T>& Sparse() const {
+        if (!has_sparse) {
+            sparse = SparsePolynomial<T>(dense);
+            has_sparse = true;
+        }
+        return sparse;
     }
 
-    // difference of two polynomials
-    Polynomial<T>& operator -= (const Polynomial<T>& other) {
-        size_t pol_size = std::max(coef.size(), other.coef.size());
-        coef.resize(pol_size, T());
-        for (size_t i = 0; i != pol_size; ++i)
-            coef[i] -= other[i];
-        Delete_Front_Zeros();
-        return *this;
+    T operator[] (uint64_t i) const {
+        return has_dense ? dense[i] : sparse[i];
     }
 
-    // product of two polynomials
-    Polynomial& operator *= (const Polynomial<T>& other) {
-        Polynomial poly = *this * other;
-        *this = poly;
-        return *this;
+    T operator() (T value) const {
+        return has_sparse ? sparse(value) : dense(value);
     }
 
-    // calculates f(value)
-    T operator() (T value) const {  
-        T ans = T();
-        for (int i = coef.size() - 1; i >= 0; --i)
-            ans = coef[i] + ans * value;  // Horner's method
-        return ans;
+    bool operator == (const HybridPolynomial& other) const {
+        if (size != other.size || degree != other.degree)
+            return false;
+        if (has_dense && other.has_dense)
+            return dense == other.dense;
+        return Sparse() == other.Sparse();
     }
 
-    typename std::vector<T>::const_iterator begin() const {
-        return coef.begin();
+    bool operator != (const HybridPolynomial& other) const {
+        return !(*this == other);
     }
 
-    typename std::vector<T>::const_iterator end() const {
-        return coef.end();
+    HybridPolynomial operator + (const HybridPolynomial& other) const {
+        if (IsSparse() || other.IsSparse())
+            return HybridPolynomial(Sparse() + other.Sparse());
+        return FromDense(Dense() + other.Dense());
     }
 
-    // returns composition
-    Polynomial<T> operator & (const Polynomial<T>& other) const {  
-        Polynomial<T> composition;
-        for (size_t i = 0; i != coef.size(); ++i) {
-            if (coef[i] != T()) {
-                Polynomial<T> tmp{T(coef[i])};
-                for (size_t j = 1; j != i + 1; ++j)
-                    tmp *= other;
-                composition += tmp;
+    HybridPolynomial operator - (const HybridPolynomial& other) const {
+        if (IsSparse() || other.IsSparse())
+            return HybridPolynomial(Sparse() - other.Sparse());
+        return FromDense(Dense() - other.Dense());
+    }
+
+    HybridPolynomial operator * (const HybridPolynomial& other) const {
+        if (size == 0 || other.size == 0)
+            return HybridPolynomial();
+        uint64_t pairs = uint64_t(size) * other.size, length = uint64_t(degree + other.degree + 1);
+        if (pairs <= length)
+            return HybridPolynomial(Sparse() * other.Sparse());
+        return FromDense(Dense() * other.Dense());
+    }
+};
+
+namespace polynomial_detail {
+
+// copies a flat array with dimension sizes from into one with sizes to, first dimension
+// innermost. Entries outside to are dropped, new entries are zero
+template <typename T>
+std::vector<T> Reshape(const std::vector<T>& a, const std::vector<size_t>& from, const std::vector<size_t>& to) {
+    size_t total = 1;
+    for (size_t n : to)
+        total *= n;
+    std::vector<T> result(total, T());
+    if (a.empty() || total == 0)
+        return result;
+    size_t k = from.size(), row = std::min(from[0], to[0]);
+    std::vector<size_t> index(k, 0);  // index of the current row in dimensions 1..k-1
+    for (size_t source = 0; source < a.size(); source += from[0]) {
+        bool inside = true;
+        size_t target = 0;
+        for (size_t i = k; i-- > 1;) {
+            inside = inside && index[i] < to[i];
+            target = target * to[i] + index[i];
+        }
+        if (inside)
+            std::copy(a.begin() + source, a.begin() + source + row, result.begin() + target * to[0]);
+        for (size_t i = 1; i != k && ++index[i] == from[i]; ++i)
+            index[i] = 0;
+    }
+    return result;
+}
+
+}  // namespace polynomial_detail
+
+// polynomial in a fixed number of variables with coefficients in one flat recursive dense
+// array: the coefficient of x_0^e_0 ... x_(k-1)^e_(k-1) sits at e_0 + n_0 * (e_1 + n_1 * (...)),
+// where n_i is one more than the degree in x_i. Products pack both operands by Kronecker
+// substitution x_i = y^(m_0 ... m_(i-1)) with the product sizes m_i, so one univariate
+// product gives the result without any carries between the variables
+template <typename T>
+class MultivariatePolynomial {
+public:
+    using Term = std::pair<std::vector<size_t>, T>;  // exponents and coefficient
+private:
+    std::vector<size_t> sizes;  // all zero for the zero polynomial
+    std::vector<T> coef;
+
+    void CheckVariables(const MultivariatePolynomial& other) const {
+        if (sizes.size() != other.sizes.size())
+            throw std::invalid_argument("MultivariatePolynomial: different numbers of variables");
+    }
+
+    static size_t Volume(const std::vector<size_t>& n) {
+        size_t total = 1;
+        for (size_t x : n) {
+            if (x != 0 && total > std::numeric_limits<size_t>::max() / x)
+                throw std::length_error("MultivariatePolynomial: too many coefficients");
+            total *= x;
+        }
+        return total;
+    }
+
+    // shrinks every size to one more than the degree in that variable
+    void Normalize() {
+        size_t k = sizes.size();
+        std::vector<size_t> used(k, 0), index(k, 0);
+        for (size_t source = 0; source < coef.size(); source += sizes[0]) {
+            size_t last = sizes[0];
+            while (last != 0 && coef[source + last - 1] == T())
+                --last;
+            if (last != 0) {
+                used[0] = std::max(used[0], last);
+                for (size_t i = 1; i != k; ++i)
+                    used[i] = std::max(used[i], index[i] + 1);
             }
+            for (size_t i = 1; i != k && ++index[i] == sizes[i]; ++i)
+                index[i] = 0;
+        }
+        if (used[0] == 0)
+            std::fill(used.begin(), used.end(), 0);
+        if (used != sizes) {
+            coef = polynomial_detail::Reshape(coef, sizes, used);
+            sizes = used;
         }
-        return composition;
     }
 
-    // divides one polynomial by another
-    Polynomial<T> operator / (const Polynomial<T>& other) const {
-        Polynomial<T> first = *this;
-        std::vector<T> result(coef.size());
-        int fd = first.Degree();
-        while (fd >= other.Degree()) {
-            T t = first[fd] / other[other.Degree()];
-            std::vector<T> tmp;
-            for (int i = 0; i != fd - other.Degree(); ++i)
-                tmp.push_back(T());
-            tmp.push_back(t);
-            Polynomial<T> p {tmp};
-            first -= other * p;
-            result[fd - other.Degree()] += t;
-            fd = first.Degree();
-        }
-        return Polynomial<T> {result};
+    // sign = 1 for the sum and -1 for the difference
+    MultivariatePolynomial Combine(const MultivariatePolynomial& other, T sign) const {
+        CheckVariables(other);
+        MultivariatePolynomial result(sizes.size());
+        for (size_t i = 0; i != sizes.size(); ++i)
+            result.sizes[i] = std::max(sizes[i], other.sizes[i]);
+        if (coef.empty() || other.coef.empty()) {
+            // one side is zero, the sizes of the other fit as they are
+            result.coef = coef.empty() ? other.coef : coef;
+            if (coef.empty()) {
+                for (T& c : result.coef)
+                    c *= sign;
+            }
+            return result;
+        }
+        result.coef = polynomial_detail::Reshape(coef, sizes, result.sizes);
+        std::vector<T> b = polynomial_detail::Reshape(other.coef, other.sizes, result.sizes);
+        for (size_t i = 0; i != b.size(); ++i)
+            result.coef[i] += sign * b[i];
+        result.Normalize();
+        return result;
+    }
+public:
+    // constant polynomial in the given number of variables
+    explicit MultivariatePolynomial(size_t variables = 1, T c = T()) : sizes(std::max<size_t>(variables, 1), 0) {
+        if (c != T()) {
+            std::fill(sizes.begin(), sizes.end(), 1);
+            coef.push_back(c);
+        }
     }
 
-    // returns remainder
-    Polynomial<T> operator % (const Polynomial<T>& other) const {  
-        return *this - (*this / other) * other;
+    // sum of the terms, equal exponents are added up
+    MultivariatePolynomial(size_t variables, const std::vector<Term>& terms) : MultivariatePolynomial(variables) {
+        std::vector<size_t> n(sizes.size(), 0);
+        for (const Term& t : terms) {
+            if (t.first.size() != sizes.size())
+                throw std::invalid_argument("MultivariatePolynomial: wrong number of exponents");
+            for (size_t i = 0; i != n.size(); ++i)
+                n[i] = std::max(n[i], t.first[i] + 1);
+        }
+        if (terms.empty())
+            return;
+        sizes = n;
+        coef.assign(Volume(sizes), T());
+        for (const Term& t : terms) {
+            size_t index = 0;
+            for (size_t i = sizes.size(); i-- != 0;)
+                index = index * sizes[i] + t.first[i];
+            coef[index] += t.second;
+        }
+        Normalize();
     }
 
-    // returns PolynomialGCD (greatest common divisor)
-    Polynomial<T> operator , (const Polynomial<T>& other) const {  
-        Polynomial<T> first = *this, second = other;
-        if (first.Degree() < second.Degree()) {
-            std::swap(first, second);
+    // the polynomial x_index
+    static MultivariatePolynomial Variable(size_t variables, size_t index) {
+        std::vector<size_t> e(std::max<size_t>(variables, 1), 0);
+        e.at(index) = 1;
+        return MultivariatePolynomial(variables, {Term(e, T(1))});
+    }
+
+    size_t Variables() const {
+        return sizes.size();
+    }
+
+    // degree in every variable, -1 for the zero polynomial
+    std::vector<int> Degrees() const {
+        std::vector<int> d(sizes.size());
+        for (size_t i = 0; i != sizes.size(); ++i)
+            d[i] = int(sizes[i]) - 1;
+        return d;
+    }
+
+    bool IsZero() const {
+        return coef.empty();
+    }
+
+    // coefficient of the monomial with these exponents
+    T operator[] (const std::vector<size_t>& exponents) const {
+        if (exponents.size() != sizes.size())
+            throw std::invalid_argument("MultivariatePolynomial: wrong number of exponents");
+        size_t index = 0;
+        for (size_t i = sizes.size(); i-- != 0;) {
+            if (exponents[i] >= sizes[i])
+                return T();
+            index = index * sizes[i] + exponents[i];
         }
-        while (second.Degree() > 0) {
-            Polynomial<T> tmp = second;
-            first = first % second;
-            second = first;
-            first = tmp;
+        return coef[index];
+    }
+
+    // coefficients in the flat layout, see Sizes
+    const std::vector<T>& Coefficients() const {
+        return coef;
+    }
+
+    const std::vector<size_t>& Sizes() const {
+        return sizes;
+    }
+
+    // Horner's method in x_0 over every row, then in x_1 over the results, and so on
+    T operator() (const std::vector<T>& point) const {
+        if (point.size() != sizes.size())
+            throw std::invalid_argument("MultivariatePolynomial: wrong number of values");
+        if (coef.empty())
+            return T();
+        std::vector<T> values = coef;
+        size_t length = values.size();
+        for (size_t i = 0; i != sizes.size(); ++i) {
+            size_t rows = length / sizes[i];
+            for (size_t r = 0; r != rows; ++r) {
+                T ans = T();
+                for (size_t j = sizes[i]; j-- != 0;)
+                    ans = values[r * sizes[i] + j] + ans * point[i];
+                values[r] = ans;
+            }
+            length = rows;
+        }
+        return values[0];
+    }
+
+    bool operator == (const MultivariatePolynomial& other) const {
+        return sizes == other.sizes && coef == other.coef;
+    }
+
+    bool operator != (const MultivariatePolynomial& other) const {
+        return !(*this == other);
+    }
+
+    MultivariatePolynomial operator + (const MultivariatePolynomial& other) const {
+        return Combine(other, T(1));
+    }
+
+    MultivariatePolynomial operator - (const MultivariatePolynomial& other) const {
+        return Combine(other, T(-1));
+    }
+
+    MultivariatePolynomial operator * (const MultivariatePolynomial& other) const {
+        CheckVariables(other);
+        MultivariatePolynomial result(sizes.size());
+        if (coef.empty() || other.coef.empty())
+            return result;
+        for (size_t i = 0; i != sizes.size(); ++i)
+            result.sizes[i] = sizes[i] + other.sizes[i] - 1;
+        Volume(result.sizes);
+        std::vector<T> a = polynomial_detail::Reshape(coef, sizes, result.sizes);
+        std::vector<T> b = polynomial_detail::Reshape(other.coef, other.sizes, result.sizes);
+        polynomial_detail::Normalize(a);
+        polynomial_detail::Normalize(b);
+        result.coef = this == &other ? polynomial_detail::Square(a) : polynomial_detail::Multiply(a, b);
+        result.coef.resize(Volume(result.sizes), T());
+        result.Normalize();
+        return result;
+    }
+
+    MultivariatePolynomial& operator += (const MultivariatePolynomial& other) {
+        return *this = *this + other;
+    }
+
+    MultivariatePolynomial& operator -= (const MultivariatePolynomial& other) {
+        return *this = *this - other;
+    }
+
+    MultivariatePolynomial& operator *= (const MultivariatePolynomial& other) {
+        return *this = *this * other;
+    }
+};
+
+// reads polynomials one per line from a large text stream, blank lines are skipped.
+// Input goes through one reusable chunk buffer and each line is parsed in place;
+// the buffer only grows for lines longer than itself
+template <typename T>
+class PolynomialTextReader {
+private:
+    std::istream& in;
+    std::vector<char> buffer;
+    size_t begin = 0, end = 0, line = 0;
+    bool exhausted = false;
+public:
+    explicit PolynomialTextReader(std::istream& input, size_t chunk = size_t(1) << 20)
+        : in(input), buffer(std::max<size_t>(chunk, 1)) {
+    }
+
+    // parses the next line into pol, returns false at the end of the stream;
+    // throws std::invalid_argument with the line number on malformed text
+    bool Next(Polynomial<T>& pol) {
+        while (true) {
+            const char* start = buffer.data() + begin;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+            if (newline || (exhausted && begin != end)) {
+                const char* stop = newline ? newline : buffer.data() + end;
+                begin = stop - buffer.data() + (newline ? 1 : 0);
+                ++line;
+                if (std::all_of(start, stop, polynomial_detail::IsBlank))
+                    continue;
+                try {
+                    pol = Polynomial<T> {polynomial_detail::ParsePolynomial<T>(start, stop)};
+                } catch (const std::invalid_argument& e) {
+                    throw std::invalid_argument("line " + std::to_string(line) + ": " + e.what());
+                }
+                return true;
+            }
+            if (exhausted)
+                return false;
+            // keep the partial line, grow only if it already fills the buffer
+            std::memmove(buffer.data(), start, end - begin);
+            end -= begin;
+            begin = 0;
+            if (end == buffer.size())
+                buffer.resize(2 * buffer.size());
+            in.read(buffer.data() + end, buffer.size() - end);
+            end += in.gcount();
+            exhausted = in.gcount() == 0;
         }
-        if (second != T(0))
-            return Polynomial(T(1));
-        first = first / first[first.Degree()];
-        return first;
     }
 };
 
+// reads one polynomial token without blanks in a FromString form, sets failbit on error
+template <typename T>
+std::istream& operator >> (std::istream& in, Polynomial<T>& pol) {
+    std::string token;
+    if (in >> token) {
+        try {
+            pol = Polynomial<T>::FromString(token);
+        } catch (const std::invalid_argument&) {
+            in.setstate(std::ios::failbit);
+        }
+    }
+    return in;
+}
+
 // overload "<<" operator to print polynomials as: std::cout << polynomial;
 // example: x^3+2*x^2-x+3
 template <typename T>
 std::ostream& operator << (std::ostream& out, const Polynomial<T>& pol) {
+    if constexpr (polynomial_detail::HasCharsFormat<T>::value) {
+        // with default stream flags std::to_chars gives the same text, written at once
+        if (out.flags() == (std::ios_base::dec | std::ios_base::skipws) && out.width() == 0) {
+            std::string buffer;
+            polynomial_detail::FormatPolynomial(pol.Coefficients(), false, int(out.precision()), buffer);
+            return out.write(buffer.data(), buffer.size());
+        }
+    }
     int deg = pol.Degree();
     if (deg == -1) {
         // zero polynomial
@@ -228,8 +4956,11 @@ std::ostream& operator << (std::ostream& out, const Polynomial<T>& pol) {
                         out << "-x^" << i;
                     if (i == 1)
                         out << "-x";
-                    if (i == 0)
+                    if (i == 0) {
+                        if (i != deg && pol[i] > T(0))
+                            out << "+";  // ModInt(-1) prints as Mod - 1
                         out << pol[i];
+                    }
                 } else if (pol[i] == T(1)) {
                     if (i != deg)
                         out << "+";